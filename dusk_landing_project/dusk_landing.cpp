@@ -4,7 +4,12 @@
  * Reusable booster touches down over eight seconds with hierarchical modeling, eased animation,
  * dusk lighting, particles, camera modes, and textured props (tower, tanks, pad).
  * Controls: C toggle cameras | 1/2 pause/play | R reset | E env | P shadow | X particles |
- *           O fog | M flame | arrows orbit | +/- or wheel zoom | ESC quit.
+ *           O fog | M flame | F profiler | K trace | [ ] particle count | I sprite path |
+ *           G CPU/GPU particles | H half-res effects | arrows orbit | +/- or wheel zoom | ESC quit.
+ *           --particles N starts with N flame particles, --dust N sizes the dust pool (default:
+ *           same as flame), --threads N sets the particle job threads (default: one per hardware
+ *           thread), --seed N replays a particle run, --gpu-particles simulates them on the GPU,
+ *           --half-res-effects starts with particles and flame drawn at half resolution.
  * Tested on macOS (Apple OpenGL) and built to compile cleanly on Linux with standard GL/GLUT/GLEW.
  */
 
@@ -21,6 +26,10 @@
 #define HAS_GLEW 0
 #endif
 
+#if !HAS_GLEW && !defined(__APPLE__) && !defined(GL_GLEXT_PROTOTYPES)
+#define GL_GLEXT_PROTOTYPES 1   // GL 2.0+ entry points straight from libGL's glext.h
+#endif
+
 #ifdef __APPLE__
 #include <OpenGL/gl.h>
 #include <OpenGL/glu.h>
@@ -40,6 +49,25 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// -DDUSK_NO_SIMD builds the plain-loop particle kernel
+#if defined(DUSK_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DUSK_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DUSK_SIMD_NEON 1
+#endif
 #include <ctime>
 
 #if __has_include(<SOIL/SOIL.h>)
@@ -76,17 +104,10 @@ inline float smoothstepRange(float edge0, float edge1, float x) {
     return smoothstep(t);
 }
 
-inline float randFloat01() {
-    return (float)std::rand() / (float)RAND_MAX;
-}
-
-inline float randRange(float minValue, float maxValue) {
-    return minValue + (maxValue - minValue) * randFloat01();
-}
-
 std::string loadTextFile(const std::string &path);
 GLuint compileShaderFromFile(const std::string &path, GLenum type, const std::vector<std::string> &defines = {});
-GLuint linkProgram(const std::vector<GLuint> &shaders, const char *debugName);
+GLuint linkProgram(const std::vector<GLuint> &shaders, const char *debugName, const char *attribute0 = nullptr,
+                   const std::vector<const char *> &feedbackVaryings = {});
 
 // ------------------------------------------------------------
 // Animation state
@@ -263,6 +284,315 @@ bool  g_mouseLeftDown = false;
 int   g_lastMouseX    = 0;
 int   g_lastMouseY    = 0;
 
+// ------------------------------------------------------------
+// GL state cache
+// ------------------------------------------------------------
+
+// Shadow copy of the state the scene toggles most: capability enables, the 2D texture binding
+// and the front-and-back material. Calls that would not change anything are skipped and
+// counted. Only state set through these helpers is tracked; attribute pushes go through
+// cachedPushAttrib/cachedPopAttrib so the copy follows the restore, and every frame starts
+// from "unknown" in case something was changed behind the cache's back.
+enum MaterialParam { MAT_AMBIENT = 0, MAT_DIFFUSE, MAT_SPECULAR, MAT_EMISSION, MAT_SHININESS, MAT_PARAM_COUNT };
+
+struct GLStateCache {
+    struct Cap { GLenum cap; int on; };     // on: 0/1, -1 unknown
+    std::vector<Cap> caps;
+    GLuint boundTexture  = 0;
+    bool   textureKnown  = false;
+    GLfloat material[MAT_PARAM_COUNT][4] = {};
+    bool    materialKnown[MAT_PARAM_COUNT] = {};
+};
+
+struct GLStateStats {
+    int issued = 0, elided = 0;             // this frame
+    int lastIssued = 0, lastElided = 0;     // previous frame, for the HUD
+};
+
+GLStateCache g_glState;
+GLStateStats g_glStateStats;
+std::vector<std::pair<GLbitfield, GLStateCache>> g_glStateStack;
+
+void invalidateGLStateCache() {
+    for (auto &c : g_glState.caps) c.on = -1;
+    g_glState.textureKnown = false;
+    std::fill(g_glState.materialKnown, g_glState.materialKnown + MAT_PARAM_COUNT, false);
+}
+
+void beginGLStateFrame() {
+    g_glStateStats.lastIssued = g_glStateStats.issued;
+    g_glStateStats.lastElided = g_glStateStats.elided;
+    g_glStateStats.issued = g_glStateStats.elided = 0;
+    invalidateGLStateCache();
+}
+
+static bool stateChanged(bool changed) {
+    ++(changed ? g_glStateStats.issued : g_glStateStats.elided);
+    return changed;
+}
+
+static void setCap(GLenum cap, int on) {
+    GLStateCache::Cap *entry = nullptr;
+    for (auto &c : g_glState.caps) {
+        if (c.cap == cap) { entry = &c; break; }
+    }
+    if (!entry) {
+        g_glState.caps.push_back({ cap, -1 });
+        entry = &g_glState.caps.back();
+    }
+    if (!stateChanged(entry->on != on)) return;
+    entry->on = on;
+    if (on) glEnable(cap); else glDisable(cap);
+}
+
+void cachedEnable(GLenum cap)  { setCap(cap, 1); }
+void cachedDisable(GLenum cap) { setCap(cap, 0); }
+
+void cachedBindTexture(GLuint texture) {
+    if (!stateChanged(!g_glState.textureKnown || g_glState.boundTexture != texture)) return;
+    g_glState.boundTexture = texture;
+    g_glState.textureKnown = true;
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+static int materialIndex(GLenum pname) {
+    switch (pname) {
+        case GL_AMBIENT:   return MAT_AMBIENT;
+        case GL_DIFFUSE:   return MAT_DIFFUSE;
+        case GL_SPECULAR:  return MAT_SPECULAR;
+        case GL_EMISSION:  return MAT_EMISSION;
+        case GL_SHININESS: return MAT_SHININESS;
+        default:           return -1;
+    }
+}
+
+// Front-and-back material, like every material call in the scene.
+void cachedMaterialfv(GLenum pname, const GLfloat *v) {
+    int i = materialIndex(pname);
+    if (i < 0) {
+        // e.g. GL_AMBIENT_AND_DIFFUSE: issue and forget what we knew
+        stateChanged(true);
+        g_glState.materialKnown[MAT_AMBIENT] = g_glState.materialKnown[MAT_DIFFUSE] = false;
+        glMaterialfv(GL_FRONT_AND_BACK, pname, v);
+        return;
+    }
+    int n = (i == MAT_SHININESS) ? 1 : 4;
+    GLfloat *cur = g_glState.material[i];
+    if (!stateChanged(!g_glState.materialKnown[i] || !std::equal(v, v + n, cur))) return;
+    std::copy(v, v + n, cur);
+    g_glState.materialKnown[i] = true;
+    glMaterialfv(GL_FRONT_AND_BACK, pname, v);
+}
+
+void cachedMaterialf(GLenum pname, GLfloat v) { cachedMaterialfv(pname, &v); }
+
+void cachedPushAttrib(GLbitfield mask) {
+    glPushAttrib(mask);
+    g_glStateStack.emplace_back(mask, g_glState);
+}
+
+void cachedPopAttrib() {
+    glPopAttrib();
+    if (g_glStateStack.empty()) {
+        invalidateGLStateCache();
+        return;
+    }
+    GLbitfield mask = g_glStateStack.back().first;
+    const GLStateCache &saved = g_glStateStack.back().second;
+    if (mask & GL_ENABLE_BIT) {
+        g_glState.caps = saved.caps;
+    } else if (mask & GL_LIGHTING_BIT) {
+        // restores the lighting enables too; forget those rather than track them separately
+        for (auto &c : g_glState.caps) {
+            if (c.cap == GL_LIGHTING || c.cap == GL_COLOR_MATERIAL ||
+                (c.cap >= GL_LIGHT0 && c.cap <= GL_LIGHT7)) c.on = -1;
+        }
+    }
+    if (mask & GL_TEXTURE_BIT) {
+        g_glState.boundTexture = saved.boundTexture;
+        g_glState.textureKnown = saved.textureKnown;
+    }
+    if (mask & GL_LIGHTING_BIT) {
+        std::copy(&saved.material[0][0], &saved.material[0][0] + 4 * MAT_PARAM_COUNT, &g_glState.material[0][0]);
+        std::copy(saved.materialKnown, saved.materialKnown + MAT_PARAM_COUNT, g_glState.materialKnown);
+    }
+    g_glStateStack.pop_back();
+}
+
+// ------------------------------------------------------------
+// Frame profiler
+// ------------------------------------------------------------
+
+// Scoped CPU timers plus GL_TIME_ELAPSED queries around each pass. Queries are double-buffered
+// by frame parity and only read once GL_QUERY_RESULT_AVAILABLE says so, so the CPU never waits
+// on the GPU (a late result just keeps the previous value). F toggles the on-screen breakdown,
+// K records the next PROFILE_CAPTURE_FRAMES frames to a Chrome trace (chrome://tracing).
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+
+enum ProfilePass {
+    PASS_ANIMATION = 0,
+    PASS_PARTICLE_UPDATE,
+    PASS_ENVIRONMENT,
+    PASS_PAD_LIGHTS,
+    PASS_BOOSTER,
+    PASS_SHADOW,
+    PASS_PARTICLES,
+    PASS_FLAME,
+    PASS_EFFECTS_DEPTH,
+    PASS_EFFECTS_UPSAMPLE,
+    PASS_HUD,
+    PASS_COUNT
+};
+
+const char *g_passNames[PASS_COUNT] = {
+    "animation", "particle update", "environment", "pad lights", "booster",
+    "planar shadow", "particles", "flame", "effects depth", "effects upsample", "hud"
+};
+
+constexpr int   PROFILE_CAPTURE_FRAMES = 120;
+constexpr float PROFILE_SMOOTHING      = 0.1f;   // EMA weight of the newest sample
+const char     *PROFILE_TRACE_FILE     = "dusk_trace.json";
+
+struct TraceEvent {
+    int pass;            // -1 = whole frame
+    bool gpu;
+    double startUs, durUs;
+};
+
+struct FrameProfiler {
+    bool   gpuTimers = false;
+    GLuint queries[2][PASS_COUNT] = {};
+    bool   pending[2][PASS_COUNT] = {};
+    double cpuStartUs[2][PASS_COUNT] = {};   // CPU time when the query was issued (trace placement)
+    int    frame = 0;                         // parity selects the query set
+    double cpuMs[PASS_COUNT] = {};
+    double gpuMs[PASS_COUNT] = {};
+    bool   gpuValid[PASS_COUNT] = {};
+    bool   ran[PASS_COUNT] = {};              // since the last beginProfiledFrame()
+    bool   active[PASS_COUNT] = {};           // ran during the previous frame
+    bool   showOverlay = false;
+    int    captureFramesLeft = 0;
+    std::vector<TraceEvent> trace;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+FrameProfiler g_profiler;
+
+static double profilerNowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - g_profiler.epoch).count();
+}
+
+static void smoothSample(double &avg, double sample) {
+    avg = (avg == 0.0) ? sample : avg + PROFILE_SMOOTHING * (sample - avg);
+}
+
+void initProfiler() {
+    const char *version = (const char *)glGetString(GL_VERSION);
+    const char *ext = (const char *)glGetString(GL_EXTENSIONS);
+    int major = 0, minor = 0;
+    if (version) std::sscanf(version, "%d.%d", &major, &minor);
+    g_profiler.gpuTimers = (major > 3 || (major == 3 && minor >= 3)) ||
+                           (ext && (std::strstr(ext, "GL_ARB_timer_query") || std::strstr(ext, "GL_EXT_timer_query")));
+    if (g_profiler.gpuTimers) glGenQueries(2 * PASS_COUNT, &g_profiler.queries[0][0]);
+}
+
+static void writeChromeTrace() {
+    std::FILE *f = std::fopen(PROFILE_TRACE_FILE, "w");
+    if (!f) {
+        std::fprintf(stderr, "Could not write %s\n", PROFILE_TRACE_FILE);
+        return;
+    }
+    std::fprintf(f, "{\"traceEvents\":[\n");
+    std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU (placed at issue time)\"}}");
+    for (const TraceEvent &e : g_profiler.trace) {
+        std::fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                     e.pass < 0 ? "frame" : g_passNames[e.pass], e.gpu ? "gpu" : "cpu",
+                     e.startUs, e.durUs, e.gpu ? 2 : 1);
+    }
+    std::fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    std::fclose(f);
+    std::fprintf(stderr, "Wrote %zu trace events to %s\n", g_profiler.trace.size(), PROFILE_TRACE_FILE);
+    g_profiler.trace.clear();
+}
+
+// Flips query sets and collects whatever GPU results of the new one have arrived. A pass that
+// did not run during the previous frame (shadow, environment or effects switched off, pad
+// lights out of range) is marked inactive and its averages are cleared, so the overlay leaves
+// it out of the totals and it starts afresh when it comes back.
+void beginProfiledFrame() {
+    FrameProfiler &P = g_profiler;
+    P.frame ^= 1;
+    for (int p = 0; p < PASS_COUNT && P.gpuTimers; ++p) {
+        if (!P.pending[P.frame][p]) continue;
+        GLuint available = 0;
+        glGetQueryObjectuiv(P.queries[P.frame][p], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint ns = 0;
+        glGetQueryObjectuiv(P.queries[P.frame][p], GL_QUERY_RESULT, &ns);
+        P.pending[P.frame][p] = false;
+        smoothSample(P.gpuMs[p], ns * 1e-6);
+        P.gpuValid[p] = true;
+        if (P.captureFramesLeft > 0) P.trace.push_back({ p, true, P.cpuStartUs[P.frame][p], ns * 1e-3 });
+    }
+    for (int p = 0; p < PASS_COUNT; ++p) {
+        P.active[p] = P.ran[p];
+        P.ran[p] = false;
+        if (P.active[p]) continue;
+        P.cpuMs[p] = 0.0;
+        P.gpuMs[p] = 0.0;
+        P.gpuValid[p] = false;
+    }
+}
+
+void endProfiledFrame(double frameStartUs) {
+    FrameProfiler &P = g_profiler;
+    if (P.captureFramesLeft <= 0) return;
+    P.trace.push_back({ -1, false, frameStartUs, profilerNowUs() - frameStartUs });
+    if (--P.captureFramesLeft == 0) writeChromeTrace();
+}
+
+void startTraceCapture() {
+    g_profiler.trace.clear();
+    g_profiler.captureFramesLeft = PROFILE_CAPTURE_FRAMES;
+}
+
+// Times one pass on the CPU and, when it issues GL work, on the GPU. Passes don't nest. If this
+// set's query for the pass is still in flight from two frames ago, the GPU side is skipped for
+// this frame: reissuing it would drop that result, and some drivers stall on the reuse.
+class ScopedPass {
+public:
+    ScopedPass(ProfilePass pass, bool gpu = true)
+        : pass_(pass), gpu_(gpu && g_profiler.gpuTimers && !g_profiler.pending[g_profiler.frame][pass]) {
+        startUs_ = profilerNowUs();
+        if (gpu_) {
+            FrameProfiler &P = g_profiler;
+            glBeginQuery(GL_TIME_ELAPSED, P.queries[P.frame][pass_]);
+            P.cpuStartUs[P.frame][pass_] = startUs_;
+        }
+    }
+    ~ScopedPass() {
+        FrameProfiler &P = g_profiler;
+        if (gpu_) {
+            glEndQuery(GL_TIME_ELAPSED);
+            P.pending[P.frame][pass_] = true;
+        }
+        double durUs = profilerNowUs() - startUs_;
+        smoothSample(P.cpuMs[pass_], durUs * 1e-3);
+        P.ran[pass_] = true;
+        if (P.captureFramesLeft > 0) P.trace.push_back({ pass_, false, startUs_, durUs });
+    }
+    ScopedPass(const ScopedPass &) = delete;
+    ScopedPass &operator=(const ScopedPass &) = delete;
+
+private:
+    ProfilePass pass_;
+    bool gpu_;
+    double startUs_;
+};
+
 // ------------------------------------------------------------
 // Textures
 // ------------------------------------------------------------
@@ -288,20 +618,20 @@ void initTextures();
 
 void bindTexture(TextureSlot slot) {
     if (slot < 0 || slot >= TEX_COUNT) {
-        glDisable(GL_TEXTURE_2D);
+        cachedDisable(GL_TEXTURE_2D);
         return;
     }
     if (!g_textures[slot]) {
-        glDisable(GL_TEXTURE_2D);
+        cachedDisable(GL_TEXTURE_2D);
         return;
     }
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, g_textures[slot]);
+    cachedEnable(GL_TEXTURE_2D);
+    cachedBindTexture(g_textures[slot]);
 }
 
 void unbindTexture() {
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glDisable(GL_TEXTURE_2D);
+    cachedBindTexture(0);
+    cachedDisable(GL_TEXTURE_2D);
 }
 
 void applyMaterial(TextureSlot slot,
@@ -313,15 +643,15 @@ void applyMaterial(TextureSlot slot,
     if (slot >= 0) {
         bindTexture(slot);
     } else {
-        glDisable(GL_TEXTURE_2D);
+        cachedDisable(GL_TEXTURE_2D);
     }
     const GLfloat *ambient = ambientOverride ? ambientOverride : diffuse;
-    glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambient);
-    glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, diffuse);
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
-    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
+    cachedMaterialfv(GL_AMBIENT, ambient);
+    cachedMaterialfv(GL_DIFFUSE, diffuse);
+    cachedMaterialfv(GL_SPECULAR, specular);
+    cachedMaterialf(GL_SHININESS, shininess);
     static const GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, emissive ? emissive : zero);
+    cachedMaterialfv(GL_EMISSION, emissive ? emissive : zero);
 }
 
 #if HAS_SOIL
@@ -338,7 +668,7 @@ GLuint loadTextureFromFile(const std::string &path, bool clamp) {
 
     GLuint tex = 0;
     glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    cachedBindTexture(tex);
     GLint wrap = clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT;
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
@@ -346,7 +676,7 @@ GLuint loadTextureFromFile(const std::string &path, bool clamp) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    cachedBindTexture(0);
     SOIL_free_image_data(data);
     return tex;
 }
@@ -557,7 +887,7 @@ void drawBoosterBody() {
     // Slightly softer highlights keep the cone from reading like chrome.
     applyMaterial(static_cast<TextureSlot>(-1), noseDiffuse, noseSpec, 18.0f, nullptr, noseAmbient);
     drawSolidCone(bodyRadius * 0.9f, 6.0f, 24);
-    glDisable(GL_TEXTURE_2D);
+    cachedDisable(GL_TEXTURE_2D);
     glPopMatrix();
 }
 
@@ -644,6 +974,17 @@ void drawBooster(bool forShadow) {
 // Environment (ground, pad, tower, tanks)
 // ------------------------------------------------------------
 
+// Static pad dimensions, shared with the particle collision heightfield (buildPadHeightfield).
+static const float PAD_RADIUS = 15.0f;
+static const float PAD_DECK_HEIGHT = 0.02f;
+static const float TRENCH_LENGTH = 12.0f;
+static const float TRENCH_WIDTH = 4.6f;
+static const float TRENCH_RECESS_DEPTH = 0.2f;
+static const float GRATE_SPACING = 4.0f;           // three grates at z = -4, 0, 4
+static const float GRATE_CENTER_Y = 0.12f;
+static const float GRATE_HEIGHT = 0.12f;
+static const float GRATE_DEPTH = 1.4f;
+
 void drawGroundPlane() {
     GLfloat ambient[]  = { 0.26f, 0.27f, 0.3f, 1.0f };
     GLfloat diffuse[]  = { 0.31f, 0.33f, 0.36f, 1.0f };
@@ -669,15 +1010,15 @@ void drawGroundPlane() {
 
 void drawPadMarkings() {
     glPushMatrix();
-    glTranslatef(0.0f, 0.02f, 0.0f);
+    glTranslatef(0.0f, PAD_DECK_HEIGHT, 0.0f);
     GLfloat ambient[]  = { 0.42f, 0.43f, 0.45f, 1.0f };
     GLfloat diffuse[]  = { 0.62f, 0.63f, 0.66f, 1.0f };
     GLfloat specular[] = { 0.08f, 0.08f, 0.08f, 1.0f };
     applyMaterial(TEX_PAD, diffuse, specular, 14.0f, nullptr, ambient);
-    drawDisk(15.0f, 96, 4.0f);
+    drawDisk(PAD_RADIUS, 96, 4.0f);
 
     // Hazard stripes
-    glDisable(GL_TEXTURE_2D);
+    cachedDisable(GL_TEXTURE_2D);
     glColor3f(0.95f, 0.8f, 0.25f);
     for (int i = 0; i < 12; ++i) {
         float ang0 = (float)i / 12.0f * 2.0f * PI;
@@ -692,9 +1033,9 @@ void drawPadMarkings() {
 
     if (g_anim.altitude < 10.0f) {
         float glow = 1.0f - clampFloat(g_anim.altitude / 10.0f, 0.0f, 1.0f);
-        glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
+        cachedPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
         glDisable(GL_LIGHTING);
-        glDisable(GL_TEXTURE_2D);
+        cachedDisable(GL_TEXTURE_2D);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE);
         glColor4f(0.95f, 0.85f, 0.45f, 0.25f + 0.35f * glow);
@@ -707,7 +1048,7 @@ void drawPadMarkings() {
             glVertex3f(std::cos(ang) * inner, 0.04f, std::sin(ang) * inner);
         }
         glEnd();
-        glPopAttrib();
+        cachedPopAttrib();
     }
 
     // Landing X
@@ -748,9 +1089,9 @@ void drawPadMarkings() {
 
 void drawFlameTrench() {
     // Keep the flame trench as a shallow, scorched inset instead of a tall wedge.
-    const float trenchLength = 12.0f;
-    const float trenchWidth  = 4.6f;
-    const float recessDepth  = 0.2f;
+    const float trenchLength = TRENCH_LENGTH;
+    const float trenchWidth  = TRENCH_WIDTH;
+    const float recessDepth  = TRENCH_RECESS_DEPTH;
 
     GLfloat concreteAmbient[] = { 0.28f, 0.26f, 0.24f, 1.0f };
     GLfloat concreteDiffuse[] = { 0.36f, 0.33f, 0.31f, 1.0f };
@@ -765,9 +1106,9 @@ void drawFlameTrench() {
     glTexCoord2f(0.0f, 1.6f); glVertex3f(-trenchWidth * 0.5f, -recessDepth,  trenchLength * 0.5f);
     glEnd();
 
-    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
+    cachedPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_COLOR_BUFFER_BIT);
     glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
+    cachedDisable(GL_TEXTURE_2D);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glColor4f(0.85f, 0.45f, 0.18f, 0.18f);
@@ -782,21 +1123,24 @@ void drawFlameTrench() {
         glVertex3f(cosA * scorchInner, -recessDepth * 0.5f, sinA * scorchInner);
     }
     glEnd();
-    glPopAttrib();
+    cachedPopAttrib();
 
     GLfloat grateAmbient[] = { 0.28f, 0.28f, 0.3f, 1.0f };
     GLfloat grateDiffuse[] = { 0.42f, 0.42f, 0.45f, 1.0f };
     GLfloat grateSpec[]    = { 0.12f, 0.12f, 0.12f, 1.0f };
     applyMaterial(static_cast<TextureSlot>(-1), grateDiffuse, grateSpec, 25.0f, nullptr, grateAmbient);
     for (int i = -1; i <= 1; ++i) {
-        float z = i * 4.0f;
+        float z = i * GRATE_SPACING;
         glPushMatrix();
-        glTranslatef(0.0f, 0.12f, z);
-        drawBox(trenchWidth * 0.9f, 0.12f, 1.4f, 1.0f, 1.0f);
+        glTranslatef(0.0f, GRATE_CENTER_Y, z);
+        drawBox(trenchWidth * 0.9f, GRATE_HEIGHT, GRATE_DEPTH, 1.0f, 1.0f);
         glPopMatrix();
     }
 }
 
+static const float TOWER_X = -25.0f;
+static const float TOWER_Z = -15.0f;
+static const float TOWER_HEIGHT = 45.0f;
 static const float TOWER_HALF_WIDTH = 2.35f;
 static const float TOWER_POST_THICKNESS = 0.28f;
 static const float TOWER_BRACE_DEPTH = 0.08f;
@@ -877,8 +1221,8 @@ void drawTrussSegment(float height) {
 // Builds stacked steel truss segments with mid-level platforms and a warning beacon.
 void drawTrussTower() {
     glPushMatrix();
-    glTranslatef(-25.0f, 0.0f, -15.0f);
-    const float towerHeight = 45.0f;
+    glTranslatef(TOWER_X, 0.0f, TOWER_Z);
+    const float towerHeight = TOWER_HEIGHT;
     const float segmentHeight = 4.5f;
     const int segmentCount = (int)std::ceil(towerHeight / segmentHeight);
 
@@ -942,7 +1286,7 @@ void drawTrussTower() {
             glPopMatrix();
         }
         GLfloat zeroEmit[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, zeroEmit);
+        cachedMaterialfv(GL_EMISSION, zeroEmit);
     }
 
     // Beacon
@@ -955,7 +1299,7 @@ void drawTrussTower() {
     drawSphere(0.5f, 16, 12);
     glPopMatrix();
     GLfloat beaconOff[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, beaconOff);
+    cachedMaterialfv(GL_EMISSION, beaconOff);
 
     glPopMatrix();
 }
@@ -977,20 +1321,28 @@ void drawLadder(float height) {
     glEnd();
 }
 
+struct TankDesc {
+    float offset;   // along x from the farm centre
+    float radius;
+    float height;   // barrel, between the base slab and the dome
+};
+
+static const TankDesc TANKS[3] = {
+    { -4.0f, 2.0f, 12.0f },
+    {  0.0f, 2.5f, 16.0f },
+    {  5.0f, 1.8f, 10.0f }
+};
+static const float TANK_FARM_X = 22.0f;
+static const float TANK_FARM_Z = -10.0f;
+static const float TANK_BASE_HEIGHT = 0.6f;   // slab 2.2 radii square, centred on the ground
+static const float TANK_DOME_HEIGHT = 2.0f;
+
 // Assembles three cryogenic tanks with domes, stripes, and service platforms to sell scale.
 void drawCryogenicTankFarm() {
-    struct TankDesc {
-        float offset;
-        float radius;
-        float height;
-    } tanks[3] = {
-        { -4.0f, 2.0f, 12.0f },
-        {  0.0f, 2.5f, 16.0f },
-        {  5.0f, 1.8f, 10.0f }
-    };
+    const TankDesc *tanks = TANKS;
 
     glPushMatrix();
-    glTranslatef(22.0f, 0.0f, -10.0f);
+    glTranslatef(TANK_FARM_X, 0.0f, TANK_FARM_Z);
 
     for (int i = 0; i < 3; ++i) {
         const TankDesc &t = tanks[i];
@@ -1001,13 +1353,13 @@ void drawCryogenicTankFarm() {
         applyMaterial(TEX_PAD, baseDiffuse, baseSpec, 10.0f, nullptr, baseAmbient);
         glPushMatrix();
         glTranslatef(t.offset, 0.0f, 0.0f);
-        drawBox(t.radius * 2.2f, 0.6f, t.radius * 2.2f, 1.0f, 1.0f);
+        drawBox(t.radius * 2.2f, TANK_BASE_HEIGHT, t.radius * 2.2f, 1.0f, 1.0f);
 
         GLfloat tankAmbient[] = { 0.52f, 0.55f, 0.6f, 1.0f };
         GLfloat tankDiffuse[] = { 0.78f, 0.82f, 0.88f, 1.0f };
         GLfloat tankSpec[]    = { 0.28f, 0.3f, 0.32f, 1.0f };
         applyMaterial(static_cast<TextureSlot>(-1), tankDiffuse, tankSpec, 35.0f, nullptr, tankAmbient);
-        glTranslatef(0.0f, 0.3f, 0.0f);
+        glTranslatef(0.0f, TANK_BASE_HEIGHT * 0.5f, 0.0f);
         drawCylinder(t.radius, t.height, 48, 1.0f, 4.0f);
         glTranslatef(0.0f, t.height, 0.0f);
         GLfloat domeAmbient[] = { 0.42f, 0.45f, 0.5f, 1.0f };
@@ -1015,7 +1367,7 @@ void drawCryogenicTankFarm() {
         GLfloat domeSpec[]    = { 0.16f, 0.16f, 0.17f, 1.0f };
         // Dome paint gets a slightly wider highlight so it blends with the barrel.
         applyMaterial(static_cast<TextureSlot>(-1), domeDiffuse, domeSpec, 22.0f, nullptr, domeAmbient);
-        drawSolidCone(t.radius, 2.0f, 32);
+        drawSolidCone(t.radius, TANK_DOME_HEIGHT, 32);
 
         // Painted insulation band around the midsection
         GLfloat bandDiffuse[] = { 0.9f, 0.65f, 0.2f, 1.0f };
@@ -1038,7 +1390,7 @@ void drawCryogenicTankFarm() {
         glTranslatef(0.0f, platformY, t.radius + 1.0f);
         drawBox(t.radius * 1.6f, 0.2f, 1.6f, 1.0f, 1.0f);
         glPopMatrix();
-        glDisable(GL_TEXTURE_2D);
+        cachedDisable(GL_TEXTURE_2D);
         glColor4f(0.55f, 0.58f, 0.6f, 1.0f);
         glBegin(GL_LINES);
         for (int line = -3; line <= 3; ++line) {
@@ -1047,7 +1399,7 @@ void drawCryogenicTankFarm() {
             glVertex3f(x, platformY + 0.12f, t.radius + 1.8f);
         }
         glEnd();
-        glEnable(GL_TEXTURE_2D);
+        cachedEnable(GL_TEXTURE_2D);
 
         // Railings
         glPushMatrix();
@@ -1134,7 +1486,7 @@ void drawFloodlights() {
         applyMaterial(static_cast<TextureSlot>(-1), lampDiffuse, lampSpec, 5.0f, lampEmit);
         drawBox(1.4f, 0.6f, 0.8f, 1.0f, 1.0f);
         GLfloat lampEmitOff[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, lampEmitOff);
+        cachedMaterialfv(GL_EMISSION, lampEmitOff);
         glPopMatrix();
     }
 }
@@ -1151,7 +1503,7 @@ void drawEnvironment() {
 void drawPadLights(float intensity) {
     if (intensity <= 0.0f) return;
 
-    glPushAttrib(GL_ENABLE_BIT | GL_LIGHTING_BIT | GL_CURRENT_BIT);
+    cachedPushAttrib(GL_ENABLE_BIT | GL_LIGHTING_BIT | GL_CURRENT_BIT);
     glDisable(GL_LIGHTING);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
@@ -1178,31 +1530,408 @@ void drawPadLights(float intensity) {
 
     glDisable(GL_BLEND);
     glEnable(GL_LIGHTING);
-    glPopAttrib();
+    cachedPopAttrib();
+}
+
+// ------------------------------------------------------------
+// Particle RNG
+// ------------------------------------------------------------
+
+// xoshiro128+ (Blackman & Vigna) run as four independent streams side by side, so one SIMD step
+// yields four numbers. Draws come from a small buffer refilled RNG_BUFFER numbers at a time.
+// Seeded explicitly through SplitMix64 from (seed, stream): the same seed replays the same run,
+// and every particle batch gets its own stream.
+const int RNG_BUFFER = 64;                  // multiple of 4
+
+struct ParticleRng {
+    std::uint32_t s[4][4] = {};             // s[word][lane]
+    float buffer[RNG_BUFFER] = {};
+    int   used = RNG_BUFFER;
+
+    ParticleRng() = default;
+    ParticleRng(std::uint64_t seed, std::uint64_t stream) {
+        std::uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        auto splitMix = [&x]() {
+            std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        for (int lane = 0; lane < 4; ++lane) {
+            for (int w = 0; w < 4; w += 2) {
+                std::uint64_t z = splitMix();
+                s[w][lane] = (std::uint32_t)z;
+                s[w + 1][lane] = (std::uint32_t)(z >> 32);
+            }
+        }
+    }
+
+    // Writes n (multiple of 4) uniform floats in [0,1), advancing all four streams n/4 steps.
+    void fill01(float *out, int n) {
+#if DUSK_SIMD_SSE2
+        __m128i s0 = _mm_loadu_si128((const __m128i *)s[0]), s1 = _mm_loadu_si128((const __m128i *)s[1]);
+        __m128i s2 = _mm_loadu_si128((const __m128i *)s[2]), s3 = _mm_loadu_si128((const __m128i *)s[3]);
+        const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+        for (int i = 0; i < n; i += 4) {
+            __m128i result = _mm_add_epi32(s0, s3);
+            __m128i t = _mm_slli_epi32(s1, 9);
+            s2 = _mm_xor_si128(s2, s0);
+            s3 = _mm_xor_si128(s3, s1);
+            s1 = _mm_xor_si128(s1, s2);
+            s0 = _mm_xor_si128(s0, s3);
+            s2 = _mm_xor_si128(s2, t);
+            s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale));
+        }
+        _mm_storeu_si128((__m128i *)s[0], s0); _mm_storeu_si128((__m128i *)s[1], s1);
+        _mm_storeu_si128((__m128i *)s[2], s2); _mm_storeu_si128((__m128i *)s[3], s3);
+#elif DUSK_SIMD_NEON
+        uint32x4_t s0 = vld1q_u32(s[0]), s1 = vld1q_u32(s[1]), s2 = vld1q_u32(s[2]), s3 = vld1q_u32(s[3]);
+        for (int i = 0; i < n; i += 4) {
+            uint32x4_t result = vaddq_u32(s0, s3);
+            uint32x4_t t = vshlq_n_u32(s1, 9);
+            s2 = veorq_u32(s2, s0);
+            s3 = veorq_u32(s3, s1);
+            s1 = veorq_u32(s1, s2);
+            s0 = veorq_u32(s0, s3);
+            s2 = veorq_u32(s2, t);
+            s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21));
+            vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(result, 8)), 1.0f / 16777216.0f));
+        }
+        vst1q_u32(s[0], s0); vst1q_u32(s[1], s1); vst1q_u32(s[2], s2); vst1q_u32(s[3], s3);
+#else
+        for (int i = 0; i < n; i += 4) {
+            for (int lane = 0; lane < 4; ++lane) {
+                std::uint32_t result = s[0][lane] + s[3][lane];
+                std::uint32_t t = s[1][lane] << 9;
+                s[2][lane] ^= s[0][lane];
+                s[3][lane] ^= s[1][lane];
+                s[1][lane] ^= s[2][lane];
+                s[0][lane] ^= s[3][lane];
+                s[2][lane] ^= t;
+                s[3][lane] = (s[3][lane] << 11) | (s[3][lane] >> 21);
+                out[i + lane] = (float)(result >> 8) * (1.0f / 16777216.0f);
+            }
+        }
+#endif
+    }
+
+    float next01() {
+        if (used == RNG_BUFFER) {
+            fill01(buffer, RNG_BUFFER);
+            used = 0;
+        }
+        return buffer[used++];
+    }
+
+    float range(float minValue, float maxValue) { return minValue + (maxValue - minValue) * next01(); }
+};
+
+// ------------------------------------------------------------
+// Job system
+// ------------------------------------------------------------
+
+// A fixed pool of worker threads that runs numbered batches. run() hands out batch indices
+// through an atomic counter, the calling thread works along, and it returns once every batch
+// is done. Which thread runs a batch varies; what a batch computes must only depend on its
+// index, so results are the same for any thread count.
+class JobSystem {
+public:
+    explicit JobSystem(int workers) {
+        for (int i = 0; i < workers; ++i) threads_.emplace_back([this] { workerLoop(); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &t : threads_) t.join();
+    }
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    int threadCount() const { return (int)threads_.size() + 1; }
+
+    void run(int batches, const std::function<void(int)> &fn) {
+        if (threads_.empty() || batches <= 1) {
+            for (int b = 0; b < batches; ++b) fn(b);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &fn;
+            batches_ = batches;
+            next_ = 0;
+            pending_ = batches;
+            ++generation_;
+        }
+        wake_.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0 && active_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void work() {
+        for (int b; (b = next_.fetch_add(1)) < batches_; ) {
+            (*job_)(b);
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        unsigned seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return quit_ || generation_ != seen; });
+            if (quit_) return;
+            seen = generation_;
+            if (!job_) continue;          // woke after that run() already finished
+            ++active_;                    // keeps run() (and its job) alive until we leave
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--active_ == 0 && pending_ == 0) done_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    const std::function<void(int)> *job_ = nullptr;
+    int batches_ = 0;
+    unsigned generation_ = 0;
+    int active_ = 0;
+    bool quit_ = false;
+    std::atomic<int> next_{ 0 };
+    std::atomic<int> pending_{ 0 };
+};
+
+int g_jobThreads = 0;                       // --threads N; 0 = one per hardware thread
+
+JobSystem &jobSystem() {
+    static JobSystem jobs(std::max(0, (g_jobThreads > 0 ? g_jobThreads : (int)std::thread::hardware_concurrency()) - 1));
+    return jobs;
 }
 
 // ------------------------------------------------------------
 // CPU particle system (engine plume + touchdown dust)
 // ------------------------------------------------------------
 
-const int CPU_PARTICLE_COUNT = 600;
+// Particles live in structure-of-arrays form: one contiguous float array per field, so the
+// update streams through only the fields it touches and integrates four particles per SIMD
+// instruction. Each effect has its own pool, with its own capacity, blend mode and kernels
+// (see Emitters below), so no loop tests what a particle is. A pool whose emitter has been
+// quiet for a lifetime, like dust away from touchdown, is skipped entirely.
+// Counts are runtime settings (--particles N, --dust N, [ and ] to halve/double).
+enum ParticleKind { PARTICLE_FLAME = 0, PARTICLE_DUST, PARTICLE_KIND_COUNT };
+
+const int DEFAULT_PARTICLE_COUNT = 600;
+const int MIN_PARTICLE_COUNT     = 64;
+const int MAX_PARTICLE_COUNT     = 1 << 22;
+const int PARTICLE_LANES         = 4;
+const float DUST_RESPAWN_DELAY   = 0.1f;    // mean wait of a dead dust slot while dust is emitted
+
+struct ParticleSoA {
+    int count = 0;                     // live slots; arrays are padded to a multiple of the lane count
+    // hot: read and written every step
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> life;
+    std::vector<float> noisePhase, noiseSpeed, noiseDirX, noiseDirZ;   // flame only
+    // cold: written on respawn, read when drawing
+    std::vector<float> maxLife, size;
+
+    int paddedCount() const { return (count + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES; }
+
+    void resize(int n) {
+        count = n;
+        std::size_t padded = (std::size_t)paddedCount();
+        for (std::vector<float> *field : { &posX, &posY, &posZ, &velX, &velY, &velZ, &life,
+                                           &noisePhase, &noiseSpeed, &noiseDirX, &noiseDirZ, &maxLife, &size }) {
+            field->assign(padded, 0.0f);
+        }
+    }
+};
+
+// The update runs in fixed slices of PARTICLE_BATCH slots on the job system. Each slice owns
+// its RNG stream and the free list of its own dead slots, so respawning needs no locks and
+// the result doesn't depend on how slices land on threads.
+const int PARTICLE_BATCH = 16384;           // multiple of PARTICLE_LANES
 
-struct CpuParticle {
-    float pos[3];
-    float vel[3];
-    float life;
-    float maxLife;
-    float size;
-    float dustFactor; // 0 = flame, 1 = dust
-    float noisePhase;
-    float noiseSpeed;
-    float noiseDir[2];
+struct ParticleBatch {
+    ParticleRng rng;
+    std::vector<int> freeList;              // PARTICLE_BATCH entries, filled without branches
+};
+
+struct ParticlePool {
+    ParticleSoA particles;
+    std::vector<ParticleBatch> batches;
+    float idleTime = 1e9f;                  // seconds since the emitter last spawned
+};
+
+// What one visible particle streams to the GPU (see Instanced particle sprites).
+struct SpriteRecord {
+    float  x, y, z, size;
+    GLubyte rgba[4];
+};
+
+// Everything an emitter needs from the booster for one simulation step, captured once by
+// captureEmitterState() rather than per respawned particle. drawParticles() reuses the last one.
+struct EmitterState {
+    float dt = 0.0f;
+    float time = 0.0f;
+    float throttle = 0.0f;
+    float baseX = 0.0f, baseZ = 0.0f;           // booster centre over the pad
+    float flameSpawnY = 0.1f;                   // just under the nozzle
+    float gimbalSinPitch = 0.0f, gimbalSinRoll = 0.0f;
+    float flameSpread = 0.0f;                   // radius of the spawn disc
+    float flameDownward = 0.0f;                 // centre of the exhaust speed range
+    float flameHorizontalScale = 1.0f;
+    float flameLifeMin = 0.0f;
+    float flameSizeBase = 0.0f;
+    bool  dustEmitting = false;
+    float tint[3] = {};                         // exhaust tint, cool to warm with throttle
+    float dustColor[3] = {};
 };
 
-CpuParticle g_particles[CPU_PARTICLE_COUNT];
+ParticlePool g_pools[PARTICLE_KIND_COUNT];
+std::uint64_t g_particleSeed = 0;          // --seed N; 0 = pick one from the clock (and print it)
+int  g_particleCount = DEFAULT_PARTICLE_COUNT;   // flame pool
+int  g_dustCount = 0;                            // dust pool; 0 = same as the flame pool
+EmitterState g_emitterState;
 bool g_particlesInitialized = false;
 GLuint g_particleTexture = 0;
 
+inline int dustCapacity() { return g_dustCount > 0 ? g_dustCount : g_particleCount; }
+
+enum ParticleBackend { PARTICLES_CPU = 0, PARTICLES_GPU };
+ParticleBackend g_particleBackend = PARTICLES_CPU;   // --gpu-particles or G
+void uploadGpuParticles();
+void stepGpuParticles(const EmitterState &e);
+
+// ------------------------------------------------------------
+// 4-wide float helpers for the particle kernel (SSE2, NEON, or plain loops)
+// ------------------------------------------------------------
+
+#if DUSK_SIMD_SSE2
+struct F4 { __m128 v; };
+inline F4 f4Load(const float *p)            { return { _mm_loadu_ps(p) }; }
+inline void f4Store(float *p, F4 a)         { _mm_storeu_ps(p, a.v); }
+inline F4 f4Set(float x)                    { return { _mm_set1_ps(x) }; }
+inline F4 operator+(F4 a, F4 b)             { return { _mm_add_ps(a.v, b.v) }; }
+inline F4 operator-(F4 a, F4 b)             { return { _mm_sub_ps(a.v, b.v) }; }
+inline F4 operator*(F4 a, F4 b)             { return { _mm_mul_ps(a.v, b.v) }; }
+inline F4 f4Max(F4 a, F4 b)                 { return { _mm_max_ps(a.v, b.v) }; }
+inline F4 f4Min(F4 a, F4 b)                 { return { _mm_min_ps(a.v, b.v) }; }
+inline F4 f4Div(F4 a, F4 b)                 { return { _mm_div_ps(a.v, b.v) }; }
+inline F4 f4Abs(F4 a)                       { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+inline F4 f4Less(F4 a, F4 b)                { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline F4 f4AndNot(F4 mask, F4 a)           { return { _mm_andnot_ps(mask.v, a.v) }; }   // ~mask & a
+inline F4 f4Select(F4 mask, F4 a, F4 b)     { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+inline F4 f4Trunc(F4 a)                     { return { _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v)) }; }
+inline void f4StoreInt(int out[4], F4 a)    { _mm_storeu_si128((__m128i *)out, _mm_cvttps_epi32(a.v)); }
+inline void f4Transpose(F4 &a, F4 &b, F4 &c, F4 &d) { _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v); }
+inline void f4PackBytes(GLubyte out[16], F4 r, F4 g, F4 b, F4 a) {   // lanes in [0,256): R,G,B,A per lane
+    __m128i rgba = _mm_or_si128(_mm_or_si128(_mm_cvttps_epi32(r.v), _mm_slli_epi32(_mm_cvttps_epi32(g.v), 8)),
+                                _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(b.v), 16), _mm_slli_epi32(_mm_cvttps_epi32(a.v), 24)));
+    _mm_storeu_si128((__m128i *)out, rgba);
+}
+#elif DUSK_SIMD_NEON
+struct F4 { float32x4_t v; };
+inline F4 f4Load(const float *p)            { return { vld1q_f32(p) }; }
+inline void f4Store(float *p, F4 a)         { vst1q_f32(p, a.v); }
+inline F4 f4Set(float x)                    { return { vdupq_n_f32(x) }; }
+inline F4 operator+(F4 a, F4 b)             { return { vaddq_f32(a.v, b.v) }; }
+inline F4 operator-(F4 a, F4 b)             { return { vsubq_f32(a.v, b.v) }; }
+inline F4 operator*(F4 a, F4 b)             { return { vmulq_f32(a.v, b.v) }; }
+inline F4 f4Max(F4 a, F4 b)                 { return { vmaxq_f32(a.v, b.v) }; }
+inline F4 f4Min(F4 a, F4 b)                 { return { vminq_f32(a.v, b.v) }; }
+#if defined(__aarch64__)
+inline F4 f4Div(F4 a, F4 b)                 { return { vdivq_f32(a.v, b.v) }; }
+#else
+inline F4 f4Div(F4 a, F4 b) {               // ARMv7 has no divide: estimate plus two Newton steps
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    return { vmulq_f32(a.v, r) };
+}
+#endif
+inline F4 f4Abs(F4 a)                       { return { vabsq_f32(a.v) }; }
+inline F4 f4Less(F4 a, F4 b)                { return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) }; }
+inline F4 f4AndNot(F4 mask, F4 a)           { return { vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(mask.v))) }; }
+inline F4 f4Select(F4 mask, F4 a, F4 b)     { return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) }; }
+inline F4 f4Trunc(F4 a)                     { return { vcvtq_f32_s32(vcvtq_s32_f32(a.v)) }; }
+inline void f4StoreInt(int out[4], F4 a)    { vst1q_s32(out, vcvtq_s32_f32(a.v)); }
+inline void f4Transpose(F4 &a, F4 &b, F4 &c, F4 &d) {
+    float32x4x2_t ab = vtrnq_f32(a.v, b.v), cd = vtrnq_f32(c.v, d.v);
+    a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+inline void f4PackBytes(GLubyte out[16], F4 r, F4 g, F4 b, F4 a) {   // lanes in [0,256): R,G,B,A per lane
+    uint8x8x4_t rgba;
+    rgba.val[0] = vmovn_u16(vcombine_u16(vmovn_u32(vcvtq_u32_f32(r.v)), vdup_n_u16(0)));
+    rgba.val[1] = vmovn_u16(vcombine_u16(vmovn_u32(vcvtq_u32_f32(g.v)), vdup_n_u16(0)));
+    rgba.val[2] = vmovn_u16(vcombine_u16(vmovn_u32(vcvtq_u32_f32(b.v)), vdup_n_u16(0)));
+    rgba.val[3] = vmovn_u16(vcombine_u16(vmovn_u32(vcvtq_u32_f32(a.v)), vdup_n_u16(0)));
+    GLubyte interleaved[32];
+    vst4_u8(interleaved, rgba);
+    std::memcpy(out, interleaved, 16);
+}
+#else
+struct F4 { float v[4]; };
+template <class Op> inline F4 f4Map(F4 a, F4 b, Op op) { F4 r; for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]); return r; }
+inline float maskBits(bool on)              { std::uint32_t u = on ? 0xFFFFFFFFu : 0u; float f; std::memcpy(&f, &u, 4); return f; }
+inline std::uint32_t bitsOf(float f)        { std::uint32_t u; std::memcpy(&u, &f, 4); return u; }
+inline F4 f4Load(const float *p)            { F4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void f4Store(float *p, F4 a)         { std::memcpy(p, a.v, sizeof(a.v)); }
+inline F4 f4Set(float x)                    { return { { x, x, x, x } }; }
+inline F4 operator+(F4 a, F4 b)             { return f4Map(a, b, [](float x, float y) { return x + y; }); }
+inline F4 operator-(F4 a, F4 b)             { return f4Map(a, b, [](float x, float y) { return x - y; }); }
+inline F4 operator*(F4 a, F4 b)             { return f4Map(a, b, [](float x, float y) { return x * y; }); }
+inline F4 f4Max(F4 a, F4 b)                 { return f4Map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline F4 f4Min(F4 a, F4 b)                 { return f4Map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+inline F4 f4Div(F4 a, F4 b)                 { return f4Map(a, b, [](float x, float y) { return x / y; }); }
+inline F4 f4Abs(F4 a)                       { return f4Map(a, a, [](float x, float) { return std::fabs(x); }); }
+inline F4 f4Less(F4 a, F4 b)                { return f4Map(a, b, [](float x, float y) { return maskBits(x < y); }); }
+inline F4 f4AndNot(F4 mask, F4 a)           { return f4Map(mask, a, [](float m, float x) { return bitsOf(m) ? 0.0f : x; }); }
+inline F4 f4Select(F4 mask, F4 a, F4 b)     { F4 r; for (int i = 0; i < 4; ++i) r.v[i] = bitsOf(mask.v[i]) ? a.v[i] : b.v[i]; return r; }
+inline F4 f4Trunc(F4 a)                     { return f4Map(a, a, [](float x, float) { return (float)(int)x; }); }
+inline void f4StoreInt(int out[4], F4 a)    { for (int i = 0; i < 4; ++i) out[i] = (int)a.v[i]; }
+inline void f4Transpose(F4 &a, F4 &b, F4 &c, F4 &d) {
+    F4 *rows[4] = { &a, &b, &c, &d };
+    for (int i = 0; i < 4; ++i) {
+        for (int j = i + 1; j < 4; ++j) std::swap(rows[i]->v[j], rows[j]->v[i]);
+    }
+}
+inline void f4PackBytes(GLubyte out[16], F4 r, F4 g, F4 b, F4 a) {   // lanes in [0,256): R,G,B,A per lane
+    for (int i = 0; i < 4; ++i) {
+        out[4 * i + 0] = (GLubyte)r.v[i];
+        out[4 * i + 1] = (GLubyte)g.v[i];
+        out[4 * i + 2] = (GLubyte)b.v[i];
+        out[4 * i + 3] = (GLubyte)a.v[i];
+    }
+}
+#endif
+
+// sin for x >= 0: wrap to [-pi, pi], then a parabola with one refinement step (|error| < 1e-3,
+// plenty for a wobble a few centimetres wide).
+inline F4 f4SinPositive(F4 x) {
+    const F4 inv2Pi = f4Set(1.0f / (2.0f * PI));
+    x = x - f4Set(2.0f * PI) * f4Trunc(x * inv2Pi + f4Set(0.5f));
+    F4 y = f4Set(4.0f / PI) * x - f4Set(4.0f / (PI * PI)) * x * f4Abs(x);
+    return f4Set(0.225f) * (y * f4Abs(y) - y) + y;
+}
+
 static void normalizeVec(float v[3]) {
     float len = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
     if (len > 0.0f) {
@@ -1234,240 +1963,1552 @@ static void ensureParticleTexture() {
     }
 
     glGenTextures(1, &g_particleTexture);
-    glBindTexture(GL_TEXTURE_2D, g_particleTexture);
+    cachedBindTexture(g_particleTexture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SIZE, SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
-    glBindTexture(GL_TEXTURE_2D, 0);
+    cachedBindTexture(0);
 }
 
-static void sampleFireColor(float lifeRatio, float &r, float &g, float &b) {
-    lifeRatio = clampFloat(lifeRatio, 0.0f, 1.0f);
-    float birth[3] = { 1.0f, 0.9f, 0.3f };
-    float midCol[3] = { 1.0f, 0.4f, 0.1f };
-    float endCol[3] = { 0.2f, 0.1f, 0.05f };
+// ------------------------------------------------------------
+// Pad collision heightfield
+// ------------------------------------------------------------
 
-    if (lifeRatio > 0.5f) {
-        float t = (lifeRatio - 0.5f) / 0.5f;
-        r = midCol[0] * (1.0f - t) + birth[0] * t;
-        g = midCol[1] * (1.0f - t) + birth[1] * t;
-        b = midCol[2] * (1.0f - t) + birth[2] * t;
-    } else {
-        float t = lifeRatio / 0.5f;
-        r = endCol[0] * (1.0f - t) + midCol[0] * t;
-        g = endCol[1] * (1.0f - t) + midCol[1] * t;
-        b = endCol[2] * (1.0f - t) + midCol[2] * t;
-    }
-}
+// The static environment around the pad (deck, trench recess, grates, tank slabs and barrels,
+// tower posts) rasterized once into a PAD_FIELD_SIZE^2 grid of top-surface heights and normals,
+// so a particle finds the ground under it with one cell lookup instead of testing geometry.
+// Normals are central differences of the heights, which makes the sides of tall cells (tanks,
+// posts) face outwards. Positions off the grid clamp onto its border, which is bare ground;
+// the floodlight masts at 40 m are outside and ignored.
+const float PAD_FIELD_HALF_EXTENT = 32.0f;
+const float PAD_FIELD_CELL        = 0.25f;
+const int   PAD_FIELD_SIZE        = 256;     // 2 * PAD_FIELD_HALF_EXTENT / PAD_FIELD_CELL
+const float PAD_STEP_HEIGHT       = 0.1f;    // deeper than this under the surface: hit a side, not a top
+
+struct PadCell {                             // 16 bytes: loaded whole, then transposed
+    float height;
+    float normal[3];
+};
 
-static void respawnParticle(CpuParticle &p, bool forceDust = false) {
-    float baseX = g_anim.offsetX;
-    float baseZ = g_anim.offsetZ;
-    float plumeY = std::max(1.0f, g_anim.altitude - 1.3f);
-    float timeRemaining = g_anim.duration - g_anim.time;
-    bool nearTouchdown = (timeRemaining <= 0.6f) || (g_anim.altitude < 6.0f);
-    bool dustAllowed = (g_anim.altitude < 4.0f) && std::fabs(g_anim.verticalSpeed) > 0.05f;
-    bool spawnDust = forceDust || (dustAllowed && nearTouchdown && randFloat01() < 0.45f);
-    float throttle = computeThrottleFactor();
-    // Particles widen and slow as throttle rises for the landing burn.
+std::vector<PadCell> g_padField;             // row-major, z rows of x cells
 
-    if (spawnDust) {
-        p.dustFactor = 1.0f;
-        float ringRadius = randRange(0.5f, 2.5f);
-        float ringTheta = randRange(0.0f, 2.0f * PI);
-        float dirX = std::cos(ringTheta);
-        float dirZ = std::sin(ringTheta);
-        p.pos[0] = baseX + dirX * ringRadius;
-        p.pos[1] = 0.12f;
-        p.pos[2] = baseZ + dirZ * ringRadius;
-        float speed = randRange(3.0f, 5.0f);
-        p.vel[0] = dirX * speed;
-        p.vel[1] = randRange(0.05f, 0.25f);
-        p.vel[2] = dirZ * speed;
-        p.maxLife = randRange(0.25f, 0.45f);
-        p.size = randRange(0.9f, 1.3f);
-    } else {
-        p.dustFactor = 0.0f;
-        const float BASE_SPREAD = 0.2f;
-        const float MAX_SPREAD  = 0.9f;
-        float spread = BASE_SPREAD + (MAX_SPREAD - BASE_SPREAD) * throttle;
-        float radial = randRange(0.0f, spread);
-        float theta = randRange(0.0f, 2.0f * PI);
-        float spreadX = std::cos(theta) * radial;
-        float spreadZ = std::sin(theta) * radial;
-        float gimbalPitch = degToRad(g_anim.gimbal);
-        float gimbalRoll  = degToRad(g_anim.gimbal * 0.5f);
-
-        p.pos[0] = baseX + spreadX;
-        p.pos[1] = std::max(0.1f, plumeY - 0.05f); // keep spawn just under the nozzle so gimbal tilt reads correctly
-        p.pos[2] = baseZ + spreadZ;
-
-        const float FAST_DESCENT = 15.0f;
-        const float SLOW_DESCENT = 6.0f;
-        float downwardCenter = SLOW_DESCENT + (FAST_DESCENT - SLOW_DESCENT) * (1.0f - throttle);
-        float downward = randRange(downwardCenter - 1.0f, downwardCenter + 1.5f);
-        float horizontalScale = 0.9f + 0.6f * throttle;
-        p.vel[0] = spreadX * horizontalScale + std::sin(gimbalRoll) * downward * 0.15f;
-        p.vel[1] = -downward;
-        p.vel[2] = spreadZ * horizontalScale + std::sin(gimbalPitch) * downward * 0.15f;
-        const float TIGHT_LIFE = 0.45f;
-        const float LOOSE_LIFE = 1.0f;
-        float lifeMin = TIGHT_LIFE + (LOOSE_LIFE - TIGHT_LIFE) * (1.0f - throttle);
-        float lifeMax = lifeMin + 0.35f;
-        p.maxLife = randRange(lifeMin, lifeMax);
-        float sizeBase = 0.4f + 0.3f * throttle;
-        p.size = randRange(sizeBase * 0.9f, sizeBase * 1.2f);
-    }
-
-    p.noisePhase = randRange(0.0f, 2.0f * PI);
-    p.noiseSpeed = randRange(1.5f, 3.5f);
-    float noiseDirTheta = randRange(0.0f, 2.0f * PI);
-    p.noiseDir[0] = std::cos(noiseDirTheta);
-    p.noiseDir[1] = std::sin(noiseDirTheta);
-    p.life = p.maxLife;
-}
-
-// Seeds exhaust/dust particles so the plume starts populated near the engine bell.
-void initParticles() {
-    static bool seeded = false;
-    if (!seeded) {
-        std::srand((unsigned int)std::time(nullptr));
-        seeded = true;
+// Height of the highest static surface at (x, z).
+static float padSurfaceHeight(float x, float z) {
+    float h = 0.0f;
+    if (x * x + z * z <= PAD_RADIUS * PAD_RADIUS) h = PAD_DECK_HEIGHT;
+    if (std::fabs(x) <= TRENCH_WIDTH * 0.5f && std::fabs(z) <= TRENCH_LENGTH * 0.5f) h = -TRENCH_RECESS_DEPTH;
+    for (int i = -1; i <= 1; ++i) {
+        if (std::fabs(x) <= TRENCH_WIDTH * 0.45f && std::fabs(z - i * GRATE_SPACING) <= GRATE_DEPTH * 0.5f) {
+            h = std::max(h, GRATE_CENTER_Y + GRATE_HEIGHT * 0.5f);
+        }
     }
-
-    ensureParticleTexture();
-    for (int i = 0; i < CPU_PARTICLE_COUNT; ++i) {
-        respawnParticle(g_particles[i]);
+    for (const TankDesc &t : TANKS) {
+        float dx = x - TANK_FARM_X - t.offset;
+        float dz = z - TANK_FARM_Z;
+        if (std::fabs(dx) <= t.radius * 1.1f && std::fabs(dz) <= t.radius * 1.1f) h = std::max(h, TANK_BASE_HEIGHT * 0.5f);
+        if (dx * dx + dz * dz <= t.radius * t.radius) {
+            h = std::max(h, TANK_BASE_HEIGHT * 0.5f + t.height + TANK_DOME_HEIGHT);
+        }
     }
-    g_particlesInitialized = true;
+    for (int i = 0; i < 4; ++i) {
+        float cx = TOWER_X + ((i & 1) ? TOWER_HALF_WIDTH : -TOWER_HALF_WIDTH);
+        float cz = TOWER_Z + ((i & 2) ? TOWER_HALF_WIDTH : -TOWER_HALF_WIDTH);
+        if (std::fabs(x - cx) <= TOWER_POST_THICKNESS * 0.5f && std::fabs(z - cz) <= TOWER_POST_THICKNESS * 0.5f) {
+            h = TOWER_HEIGHT;
+        }
+    }
+    return h;
 }
 
-// Recycles particles above the pad, fanning exhaust with gimbal tilt and spawning dust near ground.
-void updateParticles(float dt) {
-    if (!g_particlesInitialized || !g_showParticles) return;
-
-    float timeRemaining = g_anim.duration - g_anim.time;
-    bool nearTouchdown = (timeRemaining <= 0.6f) || (g_anim.altitude < 6.5f);
-    bool dustAllowed = (g_anim.altitude < 4.0f) && std::fabs(g_anim.verticalSpeed) > 0.05f;
-    float throttle = computeThrottleFactor();
-
-    for (int i = 0; i < CPU_PARTICLE_COUNT; ++i) {
-        CpuParticle &p = g_particles[i];
-        p.life -= dt;
-        if (p.life <= 0.0f) {
-            respawnParticle(p);
-            continue;
+void buildPadHeightfield() {
+    const int N = PAD_FIELD_SIZE;
+    g_padField.assign((std::size_t)N * N, PadCell());
+    for (int iz = 0; iz < N; ++iz) {
+        for (int ix = 0; ix < N; ++ix) {
+            float x = -PAD_FIELD_HALF_EXTENT + (ix + 0.5f) * PAD_FIELD_CELL;
+            float z = -PAD_FIELD_HALF_EXTENT + (iz + 0.5f) * PAD_FIELD_CELL;
+            g_padField[iz * N + ix].height = padSurfaceHeight(x, z);
         }
-
-        if (p.dustFactor < 0.5f) {
-            float wobbleScale = 0.01f + 0.025f * (1.0f - throttle);
-            float wobble = std::sin(p.noisePhase + g_anim.time * p.noiseSpeed) * wobbleScale;
-            p.vel[0] += p.noiseDir[0] * wobble;
-            p.vel[2] += p.noiseDir[1] * wobble;
-            float buoyancy = 0.35f + 0.6f * (1.0f - throttle);
-            p.vel[1] += buoyancy * dt;            // rising hot gas
-            float lateralDamp = 0.1f + 0.15f * throttle;
-            p.vel[0] *= (1.0f - lateralDamp * dt);
-            p.vel[2] *= (1.0f - lateralDamp * dt);
-        } else {
-            p.vel[1] -= 1.2f * dt;                // dust settling back down
-            if (p.vel[1] < -0.2f) p.vel[1] = -0.2f;
-            p.vel[0] *= (1.0f - 1.4f * dt);
-            p.vel[2] *= (1.0f - 1.4f * dt);
+    }
+    for (int iz = 0; iz < N; ++iz) {
+        for (int ix = 0; ix < N; ++ix) {
+            auto h = [&](int cx, int cz) {
+                return g_padField[std::min(std::max(cz, 0), N - 1) * N + std::min(std::max(cx, 0), N - 1)].height;
+            };
+            float n[3] = { (h(ix - 1, iz) - h(ix + 1, iz)) / (2.0f * PAD_FIELD_CELL), 1.0f,
+                           (h(ix, iz - 1) - h(ix, iz + 1)) / (2.0f * PAD_FIELD_CELL) };
+            normalizeVec(n);
+            std::copy(n, n + 3, g_padField[iz * N + ix].normal);
         }
+    }
+}
 
-        p.pos[0] += p.vel[0] * dt;
-        p.pos[1] += p.vel[1] * dt;
-        p.pos[2] += p.vel[2] * dt;
-
-        if (p.dustFactor < 0.5f) {
-            if (p.pos[1] < 0.8f) {
-                p.life = 0.0f; // recycle before touching ground
-            }
-        }
+// Cells under four (x, z) positions.
+inline void padCellIndices(F4 x, F4 z, int cell[4]) {
+    const F4 toCell = f4Set(1.0f / PAD_FIELD_CELL), extent = f4Set(PAD_FIELD_HALF_EXTENT);
+    const F4 lo = f4Set(0.0f), hi = f4Set(PAD_FIELD_SIZE - 1.0f);
+    F4 cx = f4Trunc(f4Min(f4Max((x + extent) * toCell, lo), hi));
+    F4 cz = f4Trunc(f4Min(f4Max((z + extent) * toCell, lo), hi));
+    f4StoreInt(cell, cz * f4Set((float)PAD_FIELD_SIZE) + cx);
+}
 
-        float minY = (p.dustFactor > 0.5f) ? 0.02f : 0.0f;
-        if (p.pos[1] < minY) p.pos[1] = minY;
+inline F4 padHeight(F4 x, F4 z) {
+    int cell[4];
+    padCellIndices(x, z, cell);
+    float h[4];
+    for (int k = 0; k < 4; ++k) h[k] = g_padField[cell[k]].height;
+    return f4Load(h);
+}
 
-        if (dustAllowed && nearTouchdown && p.dustFactor < 0.5f && randFloat01() < 0.18f * dt) {
-            respawnParticle(p, true);
-        }
-    }
+// Pushes four particles that ended the step below the surface back out. A shallow one landed
+// on a top and is lifted onto it; a deep one ran into a side and goes back to where it came
+// from across the ground. Either way the velocity component into the surface is reversed and
+// scaled by the restitution (bounce = 1 + restitution; bounce 1 slides along it).
+inline void padCollide(F4 &px, F4 &py, F4 &pz, F4 &vx, F4 &vy, F4 &vz, F4 vdt, F4 bounce) {
+    int cell[4];
+    padCellIndices(px, pz, cell);
+    const float *field = &g_padField[0].height;
+    F4 ground = f4Load(field + 4 * cell[0]), nx = f4Load(field + 4 * cell[1]);
+    F4 ny = f4Load(field + 4 * cell[2]), nz = f4Load(field + 4 * cell[3]);
+    f4Transpose(ground, nx, ny, nz);   // one cell per register -> one field per register
+    const F4 zero = f4Set(0.0f);
+    F4 depth = ground - py;
+    F4 hit = f4Less(zero, depth);
+    F4 side = f4Less(f4Set(PAD_STEP_HEIGHT), depth);
+    px = f4Select(side, px - vx * vdt, px);
+    pz = f4Select(side, pz - vz * vdt, pz);
+    py = f4Select(side, py, f4Max(py, ground));
+    F4 push = f4Select(hit, f4Min(vx * nx + vy * ny + vz * nz, zero), zero) * bounce;
+    vx = vx - push * nx;
+    vy = vy - push * ny;
+    vz = vz - push * nz;
 }
 
-// Renders exhaust sprites with additive blending and dust sprites with softer tones.
-void drawParticles() {
-    if (!g_particlesInitialized || !g_showParticles) return;
+// ------------------------------------------------------------
+// Emitters
+// ------------------------------------------------------------
 
-    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, g_particleTexture);
+// An emitter is a struct of static members describing one effect: how its particles are born,
+// move and look. Each pool is driven by the emitter at its ParticleKind in g_emitters, and the
+// pool loops are templates instantiated per emitter, so the only dispatch left is one indirect
+// call per batch. Adding an effect (tank vent steam, sparks, trench smoke) takes a ParticleKind,
+// a struct with the members below and a g_emitters entry; the GPU backend needs its own shader.
+//   ADDITIVE, MAX_LIFE, SPRITE_SCALE   blend mode, longest lifetime, sprite size factor
+//   emitting(e)                        spawning this step; a quiet emitter lets its pool go idle
+//   respawnChance(e)                   odds a dead slot comes back this step
+//   spawn(ps, i, rng, e)               one new particle in slot i
+//   integrate(ps, begin, end, e)       slots [begin,end), four at a time, lane-aligned
+//   spriteColor(ratio, e, rgb8)        life ratio to byte-scaled RGB; returns alpha
+
+// Exhaust spawns just under the nozzle, fanned by throttle and tilted with the gimbal; particles
+// widen and slow as throttle rises for the landing burn. Dust is blown off the pad while the
+// booster is low and still moving.
+static EmitterState captureEmitterState(float dt) {
+    EmitterState e;
+    e.dt = dt;
+    e.time = g_anim.time;
+    e.throttle = computeThrottleFactor();
+    e.baseX = g_anim.offsetX;
+    e.baseZ = g_anim.offsetZ;
+
+    const float throttle = e.throttle;
+    float plumeY = std::max(1.0f, g_anim.altitude - 1.3f);
+    e.flameSpawnY = std::max(0.1f, plumeY - 0.05f);   // keep spawn just under the nozzle so gimbal tilt reads correctly
+    e.gimbalSinPitch = std::sin(degToRad(g_anim.gimbal));
+    e.gimbalSinRoll  = std::sin(degToRad(g_anim.gimbal * 0.5f));
+
+    const float BASE_SPREAD = 0.2f;
+    const float MAX_SPREAD  = 0.9f;
+    e.flameSpread = BASE_SPREAD + (MAX_SPREAD - BASE_SPREAD) * throttle;
+    const float FAST_DESCENT = 15.0f;
+    const float SLOW_DESCENT = 6.0f;
+    e.flameDownward = SLOW_DESCENT + (FAST_DESCENT - SLOW_DESCENT) * (1.0f - throttle);
+    e.flameHorizontalScale = 0.9f + 0.6f * throttle;
+    const float TIGHT_LIFE = 0.45f;
+    const float LOOSE_LIFE = 1.0f;
+    e.flameLifeMin = TIGHT_LIFE + (LOOSE_LIFE - TIGHT_LIFE) * (1.0f - throttle);
+    e.flameSizeBase = 0.4f + 0.3f * throttle;
+
+    e.dustEmitting = (g_anim.altitude < 4.0f) && std::fabs(g_anim.verticalSpeed) > 0.05f;
 
-    float throttle = computeThrottleFactor();
     const float COOL_TINT[3] = { 0.85f, 0.9f, 1.0f };
     const float WARM_TINT[3] = { 1.0f, 0.55f, 0.15f };
-    float tint[3];
     for (int i = 0; i < 3; ++i) {
-        tint[i] = COOL_TINT[i] * (1.0f - throttle) + WARM_TINT[i] * throttle;
+        e.tint[i] = COOL_TINT[i] * (1.0f - throttle) + WARM_TINT[i] * throttle;
     }
+    e.dustColor[0] = 0.3f + 0.25f * throttle;
+    e.dustColor[1] = 0.28f + 0.2f * throttle;
+    e.dustColor[2] = 0.26f + 0.08f * throttle;
+    return e;
+}
 
-    float mv[16];
-    glGetFloatv(GL_MODELVIEW_MATRIX, mv);
-    float right[3] = { mv[0], mv[4], mv[8] };
-    float up[3]    = { mv[1], mv[5], mv[9] };
-    normalizeVec(right);
-    normalizeVec(up);
+// Engine exhaust: wobbles along its noise direction, rises with buoyancy, damps laterally and
+// is recycled within 0.8 m of the pad surface under it. Tight bright core near the nozzle,
+// fading to a softer orange trail.
+struct FlameEmitter {
+    static constexpr bool  ADDITIVE = true;
+    static constexpr float MAX_LIFE = 1.35f;
+    static constexpr float SPRITE_SCALE = 1.0f;
+    static constexpr float RECYCLE_HEIGHT = 0.8f;   // above the pad surface
+
+    static bool emitting(const EmitterState &) { return true; }
+    static float respawnChance(const EmitterState &) { return 1.0f; }
+
+    static void spawn(ParticleSoA &ps, int i, ParticleRng &rng, const EmitterState &e) {
+        float radial = rng.range(0.0f, e.flameSpread);
+        float theta = rng.range(0.0f, 2.0f * PI);
+        float spreadX = std::cos(theta) * radial;
+        float spreadZ = std::sin(theta) * radial;
+        ps.posX[i] = e.baseX + spreadX;
+        ps.posY[i] = e.flameSpawnY;
+        ps.posZ[i] = e.baseZ + spreadZ;
+
+        float downward = rng.range(e.flameDownward - 1.0f, e.flameDownward + 1.5f);
+        ps.velX[i] = spreadX * e.flameHorizontalScale + e.gimbalSinRoll * downward * 0.15f;
+        ps.velY[i] = -downward;
+        ps.velZ[i] = spreadZ * e.flameHorizontalScale + e.gimbalSinPitch * downward * 0.15f;
+        ps.maxLife[i] = rng.range(e.flameLifeMin, e.flameLifeMin + 0.35f);
+        ps.size[i] = rng.range(e.flameSizeBase * 0.9f, e.flameSizeBase * 1.2f);
+
+        ps.noisePhase[i] = rng.range(0.0f, 2.0f * PI);
+        ps.noiseSpeed[i] = rng.range(1.5f, 3.5f);
+        float noiseDirTheta = rng.range(0.0f, 2.0f * PI);
+        ps.noiseDirX[i] = std::cos(noiseDirTheta);
+        ps.noiseDirZ[i] = std::sin(noiseDirTheta);
+        ps.life[i] = ps.maxLife[i];
+    }
 
-    // Tight bright core near the nozzle, fading to a softer orange trail with no underground flicker.
-    glBegin(GL_QUADS);
-    for (int i = 0; i < CPU_PARTICLE_COUNT; ++i) {
-        const CpuParticle &p = g_particles[i];
-        if (p.life <= 0.0f) continue;
-        float lifeRatio = (p.maxLife > 0.0f) ? (p.life / p.maxLife) : 0.0f;
-        float baseAlpha = (p.dustFactor > 0.5f ? 0.55f : 1.1f);
-        float alpha = clampFloat(baseAlpha * lifeRatio, 0.0f, 1.0f);
-        if (alpha <= 0.01f) continue;
-
-        float r, g, b;
-        if (p.dustFactor > 0.5f) {
-            r = 0.3f + 0.25f * throttle;
-            g = 0.28f + 0.2f * throttle;
-            b = 0.26f + 0.08f * throttle;
-        } else {
-            sampleFireColor(lifeRatio, r, g, b);
-            r = clampFloat(r * 0.65f + tint[0] * 0.35f, 0.0f, 1.0f);
-            g = clampFloat(g * 0.7f + tint[1] * 0.3f, 0.0f, 1.0f);
-            b = clampFloat(b * 0.6f + tint[2] * 0.4f, 0.0f, 1.0f);
+    static void integrate(ParticleSoA &ps, int begin, int end, const EmitterState &e) {
+        const float dt = e.dt, throttle = e.throttle;
+        const F4 vdt         = f4Set(dt);
+        const F4 t           = f4Set(e.time);
+        const F4 wobbleScale = f4Set(0.01f + 0.025f * (1.0f - throttle));
+        const F4 buoyancyDt  = f4Set((0.35f + 0.6f * (1.0f - throttle)) * dt);
+        const F4 damp        = f4Set(1.0f - (0.1f + 0.15f * throttle) * dt);
+        const F4 recycleHeight = f4Set(RECYCLE_HEIGHT);
+        for (int i = begin; i < end; i += PARTICLE_LANES) {
+            F4 wobble = f4SinPositive(f4Load(&ps.noisePhase[i]) + t * f4Load(&ps.noiseSpeed[i])) * wobbleScale;
+            F4 vx = (f4Load(&ps.velX[i]) + f4Load(&ps.noiseDirX[i]) * wobble) * damp;
+            F4 vy = f4Load(&ps.velY[i]) + buoyancyDt;
+            F4 vz = (f4Load(&ps.velZ[i]) + f4Load(&ps.noiseDirZ[i]) * wobble) * damp;
+            F4 px = f4Load(&ps.posX[i]) + vx * vdt;
+            F4 py = f4Load(&ps.posY[i]) + vy * vdt;
+            F4 pz = f4Load(&ps.posZ[i]) + vz * vdt;
+            F4 ground = padHeight(px, pz);
+            F4 life = f4AndNot(f4Less(py, ground + recycleHeight), f4Load(&ps.life[i]) - vdt);
+            f4Store(&ps.velX[i], vx); f4Store(&ps.velY[i], vy); f4Store(&ps.velZ[i], vz);
+            f4Store(&ps.posX[i], px);
+            f4Store(&ps.posY[i], f4Max(py, ground));
+            f4Store(&ps.posZ[i], pz);
+            f4Store(&ps.life[i], life);
         }
-        glColor4f(r, g, b, alpha);
+    }
 
-        float size = p.size * (p.dustFactor > 0.5f ? 1.6f : 1.0f);
-        float half = size * 0.5f;
-        float rx = right[0] * half;
-        float ry = right[1] * half;
-        float rz = right[2] * half;
-        float ux = up[0] * half;
-        float uy = up[1] * half;
-        float uz = up[2] * half;
+    static F4 spriteColor(F4 ratio, const EmitterState &e, F4 rgb8[3]) {
+        const float FIRE_BIRTH[3] = { 1.0f, 0.9f, 0.3f };
+        const float FIRE_MID[3]   = { 1.0f, 0.4f, 0.1f };
+        const float FIRE_END[3]   = { 0.2f, 0.1f, 0.05f };
+        const float FIRE_KEEP[3]  = { 0.65f, 0.7f, 0.6f };   // remainder is the throttle tint
+        const F4 zero = f4Set(0.0f), one = f4Set(1.0f), half = f4Set(0.5f), two = f4Set(2.0f);
+        F4 alpha = f4Min(f4Max(f4Set(1.1f) * ratio, zero), one);
+        ratio = f4Min(f4Max(ratio, zero), one);
+        F4 upper = f4Less(half, ratio);
+        F4 t = f4Select(upper, ratio * two - one, ratio * two);
+        for (int c = 0; c < 3; ++c) {
+            F4 lo = f4Select(upper, f4Set(FIRE_MID[c]), f4Set(FIRE_END[c]));
+            F4 hi = f4Select(upper, f4Set(FIRE_BIRTH[c]), f4Set(FIRE_MID[c]));
+            F4 flame = (lo + (hi - lo) * t) * f4Set(FIRE_KEEP[c]) + f4Set(e.tint[c] * (1.0f - FIRE_KEEP[c]));
+            rgb8[c] = f4Min(f4Max(flame, zero), one) * f4Set(255.0f) + half;
+        }
+        return alpha;
+    }
+};
 
-        float px = p.pos[0];
-        float py = p.pos[1];
-        float pz = p.pos[2];
+// Touchdown dust: thrown outwards from a ring on the pad, settles at up to 0.2 m/s and damps
+// hard. It slides over the pad surface, hops softly off grates and glances off tank slabs and
+// tower posts. A flat throttle-lit grey, larger and fainter than the flame.
+struct DustEmitter {
+    static constexpr bool  ADDITIVE = false;
+    static constexpr float MAX_LIFE = 0.45f;
+    static constexpr float SPRITE_SCALE = 1.6f;
+    static constexpr float RESTITUTION = 0.3f;
+
+    static bool emitting(const EmitterState &e) { return e.dustEmitting; }
+    static float respawnChance(const EmitterState &e) {
+        return e.dustEmitting ? std::min(1.0f, e.dt / DUST_RESPAWN_DELAY) : 0.0f;
+    }
 
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(px - rx + ux, py - ry + uy, pz - rz + uz);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(px + rx + ux, py + ry + uy, pz + rz + uz);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(px + rx - ux, py + ry - uy, pz + rz - uz);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(px - rx - ux, py - ry - uy, pz - rz - uz);
+    static void spawn(ParticleSoA &ps, int i, ParticleRng &rng, const EmitterState &e) {
+        float ringRadius = rng.range(0.5f, 2.5f);
+        float ringTheta = rng.range(0.0f, 2.0f * PI);
+        float dirX = std::cos(ringTheta);
+        float dirZ = std::sin(ringTheta);
+        ps.posX[i] = e.baseX + dirX * ringRadius;
+        ps.posY[i] = 0.12f;
+        ps.posZ[i] = e.baseZ + dirZ * ringRadius;
+        float speed = rng.range(3.0f, 5.0f);
+        ps.velX[i] = dirX * speed;
+        ps.velY[i] = rng.range(0.05f, 0.25f);
+        ps.velZ[i] = dirZ * speed;
+        ps.maxLife[i] = rng.range(0.25f, MAX_LIFE);
+        ps.size[i] = rng.range(0.9f, 1.3f);
+        ps.life[i] = ps.maxLife[i];
     }
-    glEnd();
 
+    static void integrate(ParticleSoA &ps, int begin, int end, const EmitterState &e) {
+        const F4 vdt     = f4Set(e.dt);
+        const F4 damp    = f4Set(1.0f - 1.4f * e.dt);
+        const F4 fall    = f4Set(1.2f * e.dt);
+        const F4 maxFall = f4Set(-0.2f);
+        const F4 bounce  = f4Set(1.0f + RESTITUTION);
+        for (int i = begin; i < end; i += PARTICLE_LANES) {
+            F4 vx = f4Load(&ps.velX[i]) * damp;
+            F4 vy = f4Max(f4Load(&ps.velY[i]) - fall, maxFall);
+            F4 vz = f4Load(&ps.velZ[i]) * damp;
+            F4 px = f4Load(&ps.posX[i]) + vx * vdt;
+            F4 py = f4Load(&ps.posY[i]) + vy * vdt;
+            F4 pz = f4Load(&ps.posZ[i]) + vz * vdt;
+            padCollide(px, py, pz, vx, vy, vz, vdt, bounce);
+            f4Store(&ps.velX[i], vx); f4Store(&ps.velY[i], vy); f4Store(&ps.velZ[i], vz);
+            f4Store(&ps.posX[i], px); f4Store(&ps.posY[i], py); f4Store(&ps.posZ[i], pz);
+            f4Store(&ps.life[i], f4Load(&ps.life[i]) - vdt);
+        }
+    }
+
+    static F4 spriteColor(F4 ratio, const EmitterState &e, F4 rgb8[3]) {
+        for (int c = 0; c < 3; ++c) rgb8[c] = f4Set(e.dustColor[c] * 255.0f + 0.5f);
+        return f4Min(f4Max(f4Set(0.55f) * ratio, f4Set(0.0f)), f4Set(1.0f));
+    }
+};
+
+// Fills every slot of one batch (start-up and count changes).
+template <class E>
+static void fillParticleBatch(ParticlePool &pool, int b, const EmitterState &e) {
+    ParticleSoA &ps = pool.particles;
+    int end = std::min(ps.count, (b + 1) * PARTICLE_BATCH);
+    for (int i = b * PARTICLE_BATCH; i < end; ++i) E::spawn(ps, i, pool.batches[b].rng, e);
+}
+
+// One slice of one pool: integrate, gather dead slots, respawn each with the emitter's odds.
+template <class E>
+static void updateParticleBatch(ParticlePool &pool, int b, const EmitterState &e) {
+    ParticleSoA &ps = pool.particles;
+    ParticleBatch &batch = pool.batches[b];
+    const int begin = b * PARTICLE_BATCH;
+    const int end = std::min(ps.count, begin + PARTICLE_BATCH);
+    E::integrate(ps, begin, std::min(ps.paddedCount(), begin + PARTICLE_BATCH), e);
+
+    const float chance = E::respawnChance(e);
+    if (chance <= 0.0f) return;
+    int dead = 0;
+    for (int i = begin; i < end; ++i) {
+        batch.freeList[dead] = i;
+        dead += ps.life[i] <= 0.0f;
+    }
+    for (int k = 0; k < dead; ++k) {
+        if (chance < 1.0f && batch.rng.next01() >= chance) continue;
+        E::spawn(ps, batch.freeList[k], batch.rng, e);
+    }
+}
+
+template <class E>
+static int writeSpriteRecords(const ParticleSoA &ps, const EmitterState &e, SpriteRecord *out, int *slots);
+
+// The per-pool entry points, instantiated from an emitter struct.
+struct EmitterOps {
+    const char *name;
+    bool  additive;
+    float maxLife;
+    bool  (*emitting)(const EmitterState &);
+    float (*respawnChance)(const EmitterState &);
+    void  (*fillBatch)(ParticlePool &, int, const EmitterState &);
+    void  (*updateBatch)(ParticlePool &, int, const EmitterState &);
+    int   (*writeSprites)(const ParticleSoA &, const EmitterState &, SpriteRecord *, int *);
+};
+
+template <class E>
+constexpr EmitterOps makeEmitterOps(const char *name) {
+    return { name, E::ADDITIVE, E::MAX_LIFE, &E::emitting, &E::respawnChance,
+             &fillParticleBatch<E>, &updateParticleBatch<E>, &writeSpriteRecords<E> };
+}
+
+const EmitterOps g_emitters[PARTICLE_KIND_COUNT] = {   // ParticleKind order
+    makeEmitterOps<FlameEmitter>("flame"),
+    makeEmitterOps<DustEmitter>("dust"),
+};
+
+// Once an emitter has been quiet for a lifetime every particle in its pool is dead.
+inline bool particlePoolActive(int kind) { return g_pools[kind].idleTime <= g_emitters[kind].maxLife; }
+
+// Alpha-blended pools first, so additive ones brighten them instead of being covered by them.
+// Fills order with the active kinds and returns how many there are.
+static int particleDrawOrder(int order[PARTICLE_KIND_COUNT]) {
+    int n = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+            if (g_emitters[kind].additive == (pass == 1) && particlePoolActive(kind)) order[n++] = kind;
+        }
+    }
+    return n;
+}
+
+// Sizes every pool; pools whose emitter is already spawning start full, so the plume starts
+// populated near the engine bell while the dust pool starts empty.
+void initParticles() {
+    if (g_particleSeed == 0) {
+        g_particleSeed = (std::uint64_t)std::time(nullptr);
+        std::fprintf(stderr, "Particle seed: %llu (replay with --seed)\n", (unsigned long long)g_particleSeed);
+    }
+
+    ensureParticleTexture();
+    if (g_padField.empty()) buildPadHeightfield();
+    g_emitterState = captureEmitterState(0.0f);
+    const int capacity[PARTICLE_KIND_COUNT] = { g_particleCount, dustCapacity() };
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        ParticlePool &pool = g_pools[kind];
+        pool.particles.resize(capacity[kind]);
+        int batches = (capacity[kind] + PARTICLE_BATCH - 1) / PARTICLE_BATCH;
+        pool.batches.assign(batches, ParticleBatch());
+        for (int b = 0; b < batches; ++b) {
+            pool.batches[b].rng = ParticleRng(g_particleSeed, ((std::uint64_t)kind << 32) | (std::uint64_t)b);
+            pool.batches[b].freeList.resize(PARTICLE_BATCH);
+        }
+        pool.idleTime = 1e9f;
+        if (!g_emitters[kind].emitting(g_emitterState)) continue;
+        pool.idleTime = 0.0f;
+        jobSystem().run(batches, [&](int b) { g_emitters[kind].fillBatch(pool, b, g_emitterState); });
+    }
+    g_particlesInitialized = true;
+}
+
+// dust = 0 keeps the dust pool the same size as the flame pool.
+void setParticleCounts(int flame, int dust) {
+    flame = std::max(MIN_PARTICLE_COUNT, std::min(flame, MAX_PARTICLE_COUNT));
+    if (dust > 0) dust = std::max(MIN_PARTICLE_COUNT, std::min(dust, MAX_PARTICLE_COUNT));
+    if (flame == g_particleCount && dust == g_dustCount && g_particlesInitialized) return;
+    g_particleCount = flame;
+    g_dustCount = dust;
+    if (!g_particlesInitialized) return;
+    initParticles();
+    if (g_particleBackend == PARTICLES_GPU) uploadGpuParticles();
+}
+
+// Captures the emitter state, then advances every active pool in one job dispatch.
+void updateParticles(float dt) {
+    g_emitterState = captureEmitterState(dt);
+    if (!g_particlesInitialized || !g_showParticles) return;
+    const EmitterState &e = g_emitterState;
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        ParticlePool &pool = g_pools[kind];
+        pool.idleTime = g_emitters[kind].emitting(e) ? 0.0f : pool.idleTime + dt;
+    }
+    if (g_particleBackend == PARTICLES_GPU) {
+        stepGpuParticles(e);
+        return;
+    }
+
+    int firstBatch[PARTICLE_KIND_COUNT + 1] = {};
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        int batches = particlePoolActive(kind) ? (int)g_pools[kind].batches.size() : 0;
+        firstBatch[kind + 1] = firstBatch[kind] + batches;
+    }
+    jobSystem().run(firstBatch[PARTICLE_KIND_COUNT], [&](int b) {
+        int kind = 0;
+        while (b >= firstBatch[kind + 1]) ++kind;
+        g_emitters[kind].updateBatch(g_pools[kind], b - firstBatch[kind], e);
+    });
+}
+
+// ------------------------------------------------------------
+// Instanced particle sprites
+// ------------------------------------------------------------
+
+// Each visible particle streams one 20-byte SpriteRecord into one of SPRITE_RING_SLOTS regions of
+// a ring buffer, and the vertex shader expands it against a shared four-corner strip in a single
+// instanced draw. A region is rewritten only after the fence from its last draw has signalled.
+// With GL 4.4 / ARB_buffer_storage the ring stays persistently mapped; otherwise the region is
+// mapped unsynchronized each frame. Needs GL 3.3; anything older keeps the glBegin path.
+#if HAS_GLEW || !defined(__APPLE__)
+#define DUSK_GL3_API 1
+#else
+#define DUSK_GL3_API 0   // Apple's legacy gl.h has no instancing, sync or transform feedback
+#endif
+
+constexpr int SPRITE_RING_SLOTS = 3;
+bool g_instancedSprites = true;      // I switches to the immediate path for comparison
+std::vector<SpriteRecord> g_spriteScratch;   // immediate path only
+
+// Writes a record for every visible particle of one pool to out (room for ps.paddedCount()) and
+// returns how many it wrote; slots, if given, receives each record's particle slot. Four
+// particles at a time; every lane is stored and only visible ones advance the cursor.
+template <class E>
+static int writeSpriteRecords(const ParticleSoA &ps, const EmitterState &e, SpriteRecord *out, int *slots) {
+    const F4 half = f4Set(0.5f), scale8 = f4Set(255.0f), sizeScale = f4Set(E::SPRITE_SCALE);
+
+    int live = 0;
+    const int padded = ps.paddedCount();
+    for (int i = 0; i < padded; i += PARTICLE_LANES) {
+        F4 ratio = f4Div(f4Load(&ps.life[i]), f4Max(f4Load(&ps.maxLife[i]), f4Set(1e-6f)));
+        F4 rgb8[3];
+        F4 alpha8 = E::spriteColor(ratio, e, rgb8) * scale8 + half;
+        GLubyte rgba[4 * PARTICLE_LANES];
+        f4PackBytes(rgba, rgb8[0], rgb8[1], rgb8[2], alpha8);
+        float visible[PARTICLE_LANES], size[PARTICLE_LANES];
+        f4Store(visible, alpha8);
+        f4Store(size, f4Load(&ps.size[i]) * sizeScale);
+
+        for (int lane = 0; lane < PARTICLE_LANES; ++lane) {
+            SpriteRecord rec;
+            rec.x = ps.posX[i + lane];
+            rec.y = ps.posY[i + lane];
+            rec.z = ps.posZ[i + lane];
+            rec.size = size[lane];
+            std::memcpy(rec.rgba, &rgba[4 * lane], 4);
+            out[live] = rec;
+            if (slots) slots[live] = i + lane;
+            live += visible[lane] > 0.01f * 255.0f + 0.5f;
+        }
+    }
+    return live;
+}
+
+bool g_effectsOffscreen = false;   // drawing into the reduced-resolution effects target
+
+// Blend for the particle and flame layers. In the effects target the alpha channel carries the
+// layer's transmittance instead (cleared to 1, scaled by 1 - a under alpha blending, left alone
+// by additive light), so the composite can lay the premultiplied result over the scene.
+static void blendEffectLayer(GLenum src, GLenum dst) {
+    if (g_effectsOffscreen) {
+        glBlendFuncSeparate(src, dst, GL_ZERO, dst == GL_ONE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        glBlendFunc(src, dst);
+    }
+}
+
+// Additive pools add light (flame); the rest are ordinary alpha-blended haze (dust). Neither
+// writes depth, so overlapping sprites never clip each other.
+static void applyParticleBlend(bool additive) {
+    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+    if (additive) {
+        blendEffectLayer(GL_SRC_ALPHA, GL_ONE);
+    } else {
+        blendEffectLayer(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
+
+// ------------------------------------------------------------
+// Particle depth sort (alpha-blended pools)
+// ------------------------------------------------------------
+
+// Alpha-blended sprites only composite correctly back to front, so the visible records of every
+// non-additive pool are ordered by view depth before they are streamed, with an LSD radix sort
+// over (key, record) pairs: 16-bit keys quantized over the pool's depth span when that still
+// resolves DEPTH_KEY_STEP (two 8-bit passes), order-preserving 32-bit float keys otherwise (four).
+// Dense dust is too incoherent from frame to frame for an incremental re-sort to pay off (a third
+// or more of neighbours swap every step), so every frame is sorted in full. The input is last frame's
+// order (by slot) with newly visible records after it; the sort is stable, so records sharing a
+// key keep their order from frame to frame instead of flickering.
+// Large sorts split every pass, and the key and gather loops, across the job system.
+const float DEPTH_KEY_STEP            = 0.001f;    // metres
+const int   DEPTH_SORT_CHUNK          = PARTICLE_BATCH;
+const int   DEPTH_SORT_PARALLEL_MIN   = 4 * DEPTH_SORT_CHUNK;   // smaller sorts stay on one thread
+
+enum DepthSortMethod { DEPTH_SORT_NONE = 0, DEPTH_SORT_RADIX16, DEPTH_SORT_RADIX32 };
+
+struct DepthSortState {
+    std::vector<int> order;                // last frame's back-to-front slots
+    std::vector<int> recordOfSlot;         // pool-sized, -1 everywhere between frames
+    std::vector<int> slots;                // this frame: slot of each record
+    std::vector<SpriteRecord> records;     // this frame: records in slot order
+    std::vector<float> recordDepth, depth;
+    std::vector<std::uint32_t> items, itemTmp;
+    std::vector<std::uint16_t> keys16, keyTmp16;
+    std::vector<std::uint32_t> keys32, keyTmp32;
+    std::vector<int> histograms;           // 256 per chunk
+    DepthSortMethod lastMethod = DEPTH_SORT_NONE;
+};
+
+DepthSortState g_depthSort[PARTICLE_KIND_COUNT];
+
+static int depthSortChunks(int n) {
+    return n >= DEPTH_SORT_PARALLEL_MIN ? (n + DEPTH_SORT_CHUNK - 1) / DEPTH_SORT_CHUNK : 1;
+}
+
+// Stable LSD radix sort of (keys, items) by 8-bit digits. Each pass histograms its chunks in
+// parallel, turns the counts into per-chunk offsets, then scatters every chunk in parallel; a
+// pass whose digit is the same for every key is skipped.
+template <class Key>
+static void radixSortPairs(std::vector<Key> &keys, std::vector<std::uint32_t> &items,
+                           std::vector<Key> &keyTmp, std::vector<std::uint32_t> &itemTmp,
+                           std::vector<int> &histograms, int n) {
+    const int chunks = depthSortChunks(n);
+    const int chunkSize = (n + chunks - 1) / chunks;
+    keyTmp.resize(n);
+    itemTmp.resize(n);
+    histograms.resize((std::size_t)chunks * 256);
+
+    for (int shift = 0; shift < (int)sizeof(Key) * 8; shift += 8) {
+        jobSystem().run(chunks, [&](int c) {
+            int *hist = &histograms[(std::size_t)c * 256];
+            std::fill(hist, hist + 256, 0);
+            int end = std::min(n, (c + 1) * chunkSize);
+            for (int i = c * chunkSize; i < end; ++i) ++hist[(keys[i] >> shift) & 0xFF];
+        });
+        bool trivial = false;
+        int sum = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            int digitTotal = 0;
+            for (int c = 0; c < chunks; ++c) {
+                int &count = histograms[(std::size_t)c * 256 + digit];
+                int v = count;
+                count = sum;
+                sum += v;
+                digitTotal += v;
+            }
+            trivial |= digitTotal == n;
+        }
+        if (trivial) continue;
+        jobSystem().run(chunks, [&](int c) {
+            int *offset = &histograms[(std::size_t)c * 256];
+            int end = std::min(n, (c + 1) * chunkSize);
+            for (int i = c * chunkSize; i < end; ++i) {
+                int dst = offset[(keys[i] >> shift) & 0xFF]++;
+                keyTmp[dst] = keys[i];
+                itemTmp[dst] = items[i];
+            }
+        });
+        keys.swap(keyTmp);
+        items.swap(itemTmp);
+    }
+}
+
+// Float bits reordered so unsigned comparison matches float comparison.
+static inline std::uint32_t orderedFloatBits(float f) {
+    std::uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+// Reorders items [0,n) by S.depth (S.depth itself is left as is).
+static void radixDepthSort(DepthSortState &S, int n) {
+    const int chunks = depthSortChunks(n);
+    const int chunkSize = (n + chunks - 1) / chunks;
+    auto range = std::minmax_element(S.depth.begin(), S.depth.end());
+    const float nearest = *range.first;
+    const float span = *range.second - nearest;
+    if (span <= DEPTH_KEY_STEP * 65535.0f) {
+        const float scale = span > 0.0f ? 65535.0f / span : 0.0f;
+        S.keys16.resize(n);
+        jobSystem().run(chunks, [&](int c) {
+            int end = std::min(n, (c + 1) * chunkSize);
+            for (int k = c * chunkSize; k < end; ++k) {
+                S.keys16[k] = (std::uint16_t)((S.depth[k] - nearest) * scale + 0.5f);
+            }
+        });
+        radixSortPairs(S.keys16, S.items, S.keyTmp16, S.itemTmp, S.histograms, n);
+        S.lastMethod = DEPTH_SORT_RADIX16;
+    } else {
+        S.keys32.resize(n);
+        jobSystem().run(chunks, [&](int c) {
+            int end = std::min(n, (c + 1) * chunkSize);
+            for (int k = c * chunkSize; k < end; ++k) S.keys32[k] = orderedFloatBits(S.depth[k]);
+        });
+        radixSortPairs(S.keys32, S.items, S.keyTmp32, S.itemTmp, S.histograms, n);
+        S.lastMethod = DEPTH_SORT_RADIX32;
+    }
+}
+
+// Writes the visible records of one alpha-blended pool to out, farthest first, and returns how
+// many. viewZ is the modelview row that gives eye-space z.
+static int writeDepthSortedSprites(int kind, const float viewZ[4], SpriteRecord *out) {
+    DepthSortState &S = g_depthSort[kind];
+    const ParticleSoA &ps = g_pools[kind].particles;
+    if ((int)S.recordOfSlot.size() != ps.count) {   // pool resized: last frame's order is void
+        S.recordOfSlot.assign(ps.count, -1);
+        S.order.clear();
+    }
+    S.records.resize(ps.paddedCount());
+    S.slots.resize(ps.paddedCount());
+    const int n = g_emitters[kind].writeSprites(ps, g_emitterState, S.records.data(), S.slots.data());
+
+    // Last frame's order first, then whatever has become visible since.
+    for (int r = 0; r < n; ++r) S.recordOfSlot[S.slots[r]] = r;
+    S.items.resize(n);
+    int m = 0;
+    for (int slot : S.order) {
+        if (slot >= ps.count || S.recordOfSlot[slot] < 0) continue;
+        S.items[m++] = (std::uint32_t)S.recordOfSlot[slot];
+        S.recordOfSlot[slot] = -1;
+    }
+    for (int r = 0; r < n; ++r) {
+        int &record = S.recordOfSlot[S.slots[r]];
+        if (record < 0) continue;
+        S.items[m++] = (std::uint32_t)r;
+        record = -1;
+    }
+
+    const int chunks = depthSortChunks(n);
+    const int chunkSize = (n + chunks - 1) / chunks;
+    S.recordDepth.resize(n);
+    S.depth.resize(n);
+    jobSystem().run(chunks, [&](int c) {
+        int end = std::min(n, (c + 1) * chunkSize);
+        for (int r = c * chunkSize; r < end; ++r) {
+            const SpriteRecord &rec = S.records[r];
+            S.recordDepth[r] = viewZ[0] * rec.x + viewZ[1] * rec.y + viewZ[2] * rec.z + viewZ[3];
+        }
+    });
+    for (int k = 0; k < n; ++k) S.depth[k] = S.recordDepth[S.items[k]];
+
+    radixDepthSort(S, n);
+
+    S.order.resize(n);
+    jobSystem().run(chunks, [&](int c) {
+        int end = std::min(n, (c + 1) * chunkSize);
+        for (int k = c * chunkSize; k < end; ++k) {
+            out[k] = S.records[S.items[k]];
+            S.order[k] = S.slots[S.items[k]];
+        }
+    });
+    return n;
+}
+
+static const char *depthSortMethodName(DepthSortMethod method) {
+    switch (method) {
+        case DEPTH_SORT_RADIX16:  return "radix 16-bit";
+        case DEPTH_SORT_RADIX32:  return "radix 32-bit";
+        default:                  return "idle";
+    }
+}
+
+// Where each active pool's records sit in a sprite buffer, per kind, plus the draw order.
+struct SpriteBatches {
+    int order[PARTICLE_KIND_COUNT];
+    int pools = 0;
+    int first[PARTICLE_KIND_COUNT] = {};
+    int count[PARTICLE_KIND_COUNT] = {};
+};
+
+static int spriteRecordCapacity() {
+    int records = 0;
+    for (const ParticlePool &pool : g_pools) records += pool.particles.paddedCount();
+    return records;
+}
+
+// Writes every active pool's records back to back in draw order, alpha-blended pools depth
+// sorted; returns the total.
+static int writeAllSpriteRecords(SpriteBatches &batches, const float viewZ[4], SpriteRecord *out) {
+    batches.pools = particleDrawOrder(batches.order);
+    int total = 0;
+    for (int k = 0; k < batches.pools; ++k) {
+        int kind = batches.order[k];
+        batches.first[kind] = total;
+        if (g_emitters[kind].additive) {
+            batches.count[kind] = g_emitters[kind].writeSprites(g_pools[kind].particles, g_emitterState, out + total, nullptr);
+        } else {
+            batches.count[kind] = writeDepthSortedSprites(kind, viewZ, out + total);
+        }
+        total += batches.count[kind];
+    }
+    return total;
+}
+
+#if DUSK_GL3_API
+const char *SPRITE_VERTEX_SHADER = R"(#version 120
+attribute vec2 corner;          // (+-1, +-1), shared by every instance
+attribute vec4 center;          // xyz position, w sprite size
+attribute vec4 color;
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+varying vec2 texCoord;
+varying vec4 spriteColor;
+void main() {
+    vec3 offset = (cameraRight * corner.x + cameraUp * corner.y) * (0.5 * center.w);
+    vec4 eye = gl_ModelViewMatrix * vec4(center.xyz + offset, 1.0);
+    gl_Position = gl_ProjectionMatrix * eye;
+    gl_FogFragCoord = abs(eye.z);
+    texCoord = corner * 0.5 + 0.5;
+    spriteColor = color;
+}
+)";
+
+const char *SPRITE_FRAGMENT_SHADER = R"(#version 120
+uniform sampler2D spriteTexture;
+uniform bool fogEnabled;        // GL_EXP2, matching setupFog()
+varying vec2 texCoord;
+varying vec4 spriteColor;
+void main() {
+    vec4 c = texture2D(spriteTexture, texCoord) * spriteColor;
+    if (fogEnabled) {
+        float d = gl_Fog.density * gl_FogFragCoord;
+        c.rgb = mix(gl_Fog.color.rgb, c.rgb, clamp(exp(-d * d), 0.0, 1.0));
+    }
+    gl_FragColor = c;
+}
+)";
+
+struct SpriteRing {
+    bool   supported = false;        // GL 3.3 context and the sprite program linked
+    bool   persistent = false;       // buffer storage: mapped once for the ring's lifetime
+    GLuint program = 0;
+    GLint  locCorner = -1, locCenter = -1, locColor = -1;
+    GLint  locRight = -1, locUp = -1, locFog = -1;
+    GLuint cornerBuffer = 0;
+    GLuint buffer = 0;
+    int    capacity = 0;             // records per slot
+    SpriteRecord *mapped = nullptr;  // whole ring, persistent path only
+    GLsync fences[SPRITE_RING_SLOTS] = {};
+    int    slot = 0;
+};
+
+SpriteRing g_spriteRing;
+
+// define, when given, is #defined right after the #version line, which has to stay first.
+static GLuint compileShaderSource(const char *source, GLenum type, const char *debugName,
+                                  const char *define = nullptr) {
+    std::string prelude;
+    const char *body = source;
+    if (define) {
+        const char *eol = std::strchr(source, '\n');
+        body = eol ? eol + 1 : source + std::strlen(source);
+        prelude.assign(source, body);
+        prelude += std::string("#define ") + define + "\n";
+    }
+    const char *parts[2] = { prelude.c_str(), body };
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 2, parts, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = "";
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "%s shader failed to compile:\n%s\n", debugName, log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// attribute0 is bound to location 0 (compatibility contexts only draw when attribute 0 is
+// enabled); feedbackVaryings are captured interleaved for transform feedback.
+GLuint linkProgram(const std::vector<GLuint> &shaders, const char *debugName, const char *attribute0,
+                   const std::vector<const char *> &feedbackVaryings) {
+    GLuint program = glCreateProgram();
+    for (GLuint shader : shaders) glAttachShader(program, shader);
+    if (attribute0) glBindAttribLocation(program, 0, attribute0);
+    if (!feedbackVaryings.empty()) {
+        glTransformFeedbackVaryings(program, (GLsizei)feedbackVaryings.size(), feedbackVaryings.data(),
+                                    GL_INTERLEAVED_ATTRIBS);
+    }
+    glLinkProgram(program);
+    for (GLuint shader : shaders) {
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+    }
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024] = "";
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::fprintf(stderr, "%s program failed to link:\n%s\n", debugName, log);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void initParticleSprites() {
+    SpriteRing &R = g_spriteRing;
+    const char *version = (const char *)glGetString(GL_VERSION);
+    const char *ext = (const char *)glGetString(GL_EXTENSIONS);
+    int major = 0, minor = 0;
+    if (version) std::sscanf(version, "%d.%d", &major, &minor);
+    if (major < 3 || (major == 3 && minor < 3)) {
+        std::fprintf(stderr, "OpenGL %d.%d: instanced particle sprites need 3.3, using immediate mode\n", major, minor);
+        return;
+    }
+    R.persistent = (major > 4 || (major == 4 && minor >= 4)) || (ext && std::strstr(ext, "GL_ARB_buffer_storage"));
+
+    GLuint vs = compileShaderSource(SPRITE_VERTEX_SHADER, GL_VERTEX_SHADER, "Particle sprite vertex");
+    GLuint fs = compileShaderSource(SPRITE_FRAGMENT_SHADER, GL_FRAGMENT_SHADER, "Particle sprite fragment");
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return;
+    }
+    R.program = linkProgram({ vs, fs }, "Particle sprite", "corner");
+    if (!R.program) return;
+
+    R.locCorner = glGetAttribLocation(R.program, "corner");
+    R.locCenter = glGetAttribLocation(R.program, "center");
+    R.locColor  = glGetAttribLocation(R.program, "color");
+    R.locRight  = glGetUniformLocation(R.program, "cameraRight");
+    R.locUp     = glGetUniformLocation(R.program, "cameraUp");
+    R.locFog    = glGetUniformLocation(R.program, "fogEnabled");
+    if (R.locCorner < 0 || R.locCenter < 0 || R.locColor < 0) {
+        std::fprintf(stderr, "Particle sprite program is missing an attribute, using immediate mode\n");
+        glDeleteProgram(R.program);
+        R.program = 0;
+        return;
+    }
+    glUseProgram(R.program);
+    glUniform1i(glGetUniformLocation(R.program, "spriteTexture"), 0);
+    glUseProgram(0);
+
+    const float corners[8] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+    glGenBuffers(1, &R.cornerBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, R.cornerBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    R.supported = true;
+}
+
+static void waitSpriteSlot(int slot) {
+    GLsync &fence = g_spriteRing.fences[slot];
+    if (!fence) return;
+    glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);   // 1 s: never hang on a lost GPU
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+static void releaseSpriteBuffer() {
+    SpriteRing &R = g_spriteRing;
+    for (int slot = 0; slot < SPRITE_RING_SLOTS; ++slot) waitSpriteSlot(slot);
+    if (R.buffer) {
+        if (R.mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, R.buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            R.mapped = nullptr;
+        }
+        glDeleteBuffers(1, &R.buffer);
+        R.buffer = 0;
+    }
+    R.capacity = 0;
+}
+
+// Grows the ring to hold `records` sprites per slot (the particle count can change at runtime).
+static bool reserveSpriteBuffer(int records) {
+    SpriteRing &R = g_spriteRing;
+    if (records <= R.capacity) return true;
+    releaseSpriteBuffer();
+    GLsizeiptr bytes = (GLsizeiptr)records * SPRITE_RING_SLOTS * (GLsizeiptr)sizeof(SpriteRecord);
+    glGenBuffers(1, &R.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, R.buffer);
+    if (R.persistent) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+        R.mapped = (SpriteRecord *)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (R.persistent && !R.mapped) {
+        std::fprintf(stderr, "Could not map the particle sprite ring, using immediate mode\n");
+        releaseSpriteBuffer();
+        R.supported = false;
+        return false;
+    }
+    R.capacity = records;
+    return true;
+}
+
+// Returns false when the caller should draw with the immediate path instead.
+static bool drawParticleSprites(const float right[3], const float up[3], const float viewZ[4]) {
+    SpriteRing &R = g_spriteRing;
+    if (!R.supported || !g_instancedSprites || !reserveSpriteBuffer(spriteRecordCapacity())) return false;
+
+    R.slot = (R.slot + 1) % SPRITE_RING_SLOTS;
+    waitSpriteSlot(R.slot);
+    const GLintptr offset = (GLintptr)R.slot * R.capacity * (GLintptr)sizeof(SpriteRecord);
+    glBindBuffer(GL_ARRAY_BUFFER, R.buffer);
+    SpriteRecord *out = R.mapped ? R.mapped + (std::size_t)R.slot * R.capacity
+                                 : (SpriteRecord *)glMapBufferRange(GL_ARRAY_BUFFER, offset,
+                                       (GLsizeiptr)R.capacity * (GLsizeiptr)sizeof(SpriteRecord),
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!out) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return false;
+    }
+
+    // Every pool shares the slot, so one map and one fence cover the whole pass.
+    SpriteBatches batches;
+    int live = writeAllSpriteRecords(batches, viewZ, out);
+    if (!R.mapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    if (live > 0) {
+        glUseProgram(R.program);
+        glUniform3fv(R.locRight, 1, right);
+        glUniform3fv(R.locUp, 1, up);
+        glUniform1i(R.locFog, g_fogEnabled ? 1 : 0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, R.cornerBuffer);
+        glEnableVertexAttribArray(R.locCorner);
+        glVertexAttribPointer(R.locCorner, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindBuffer(GL_ARRAY_BUFFER, R.buffer);
+        glEnableVertexAttribArray(R.locCenter);
+        glEnableVertexAttribArray(R.locColor);
+        glVertexAttribDivisor(R.locCenter, 1);
+        glVertexAttribDivisor(R.locColor, 1);
+
+        for (int k = 0; k < batches.pools; ++k) {
+            int kind = batches.order[k];
+            if (batches.count[kind] == 0) continue;
+            const GLintptr start = offset + (GLintptr)batches.first[kind] * (GLintptr)sizeof(SpriteRecord);
+            applyParticleBlend(g_emitters[kind].additive);
+            glVertexAttribPointer(R.locCenter, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteRecord), (const void *)start);
+            glVertexAttribPointer(R.locColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteRecord),
+                                  (const void *)(start + offsetof(SpriteRecord, rgba)));
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batches.count[kind]);
+        }
+
+        // Divisors stick to the attribute index, and index 0 aliases glVertexPointer arrays.
+        glVertexAttribDivisor(R.locCenter, 0);
+        glVertexAttribDivisor(R.locColor, 0);
+        glDisableVertexAttribArray(R.locCorner);
+        glDisableVertexAttribArray(R.locCenter);
+        glDisableVertexAttribArray(R.locColor);
+        glUseProgram(0);
+        R.fences[R.slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+static const char *particleSpritePath() {
+    if (!g_spriteRing.supported) return "immediate (no GL 3.3)";
+    if (!g_instancedSprites) return "immediate";
+    return g_spriteRing.persistent ? "instanced, persistent ring" : "instanced, mapped ring";
+}
+#else
+void initParticleSprites() {}
+
+static bool drawParticleSprites(const float *, const float *, const float *) { return false; }
+
+static const char *particleSpritePath() { return "immediate"; }
+#endif
+
+// ------------------------------------------------------------
+// GPU particle backend (transform feedback)
+// ------------------------------------------------------------
+
+// The same integration and respawn rules as FlameEmitter/DustEmitter::integrate and ::spawn,
+// run in a vertex shader over GL_POINTS with the rasterizer off, ping-ponging between two
+// buffers of GpuParticle records per pool. Each pool gets its own program pair, built from one
+// source with DUST_POOL defined or not, so neither shader branches on particle kind. Per step the CPU only
+// sets the emitter uniforms; respawn randomness hashes (seed, particle, step) on the GPU.
+// g_padField is mirrored into a float texture so both pools collide with the same surface.
+// Sprites are then instanced straight from the latest buffer. Needs the GL 3.3 sprite path.
+struct GpuParticle {
+    float posLife[4];      // xyz position, life
+    float velMaxLife[4];   // xyz velocity, max life
+    float noise[4];        // flame only: phase, speed, direction x, direction z
+    float shape[4];        // size
+};
+
+#if DUSK_GL3_API
+const char *PARTICLE_SIM_SHADER = R"(#version 130
+in vec4 inPosLife;
+in vec4 inVelMaxLife;
+in vec4 inNoise;
+in vec4 inShape;
+out vec4 outPosLife;
+out vec4 outVelMaxLife;
+out vec4 outNoise;
+out vec4 outShape;
+uniform float dt;
+uniform float time;
+uniform float throttle;
+uniform float spawnY;              // flame spawn height, just under the nozzle
+uniform float flameSpread;         // flame only: captureEmitterState() values for the step
+uniform float flameDownward;
+uniform float flameHorizontalScale;
+uniform float flameLifeMin;
+uniform float flameSizeBase;
+uniform vec2  gimbalSin;           // sin of gimbal roll, pitch
+uniform vec2  offset;              // booster x, z
+uniform float respawnChance;       // dust only: odds a dead particle comes back this step
+uniform uint  seed;
+uniform uint  step;
+uniform sampler2D padField;        // g_padField: r height, gba normal
+uniform vec3  padGrid;             // half extent, 1 / cell size, last cell index
+uniform float padStepHeight;       // PAD_STEP_HEIGHT
+uniform float dustBounce;          // dust only: 1 + DustEmitter::RESTITUTION
+uniform float recycleHeight;       // flame only: FlameEmitter::RECYCLE_HEIGHT
+
+const float PI = 3.14159265359;
+uint rngState;
+
+uint pcgHash(uint v) {
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+float next01() {
+    rngState = pcgHash(rngState);
+    return float(rngState >> 8u) * (1.0 / 16777216.0);
+}
+float range(float a, float b) { return a + (b - a) * next01(); }
+
+// Same cell as padCellIndices(): clamp onto the grid, then truncate.
+vec4 padCell(vec2 xz) {
+    return texelFetch(padField, ivec2(clamp((xz + padGrid.x) * padGrid.y, 0.0, padGrid.z)), 0);
+}
+
+#ifdef DUST_POOL
+void respawn() {
+    float ringRadius = range(0.5, 2.5);
+    float ringTheta = range(0.0, 2.0 * PI);
+    vec2 dir = vec2(cos(ringTheta), sin(ringTheta));
+    float speed = range(3.0, 5.0);
+    float maxLife = range(0.25, 0.45);
+    outPosLife = vec4(offset.x + dir.x * ringRadius, 0.12, offset.y + dir.y * ringRadius, maxLife);
+    outVelMaxLife = vec4(dir.x * speed, range(0.05, 0.25), dir.y * speed, maxLife);
+    outShape = vec4(range(0.9, 1.3), 0.0, 0.0, 0.0);
+}
+
+void main() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);   // required before GLSL 1.40; nothing is rasterized
+    rngState = pcgHash(uint(gl_VertexID) ^ pcgHash(step ^ pcgHash(seed)));
+    vec3 vel = inVelMaxLife.xyz;
+    vel.xz *= 1.0 - 1.4 * dt;
+    vel.y = max(vel.y - 1.2 * dt, -0.2);
+    vec3 pos = inPosLife.xyz + vel * dt;
+    vec4 pad = padCell(pos.xz);        // as padCollide()
+    float depth = pad.x - pos.y;
+    if (depth > padStepHeight) pos.xz -= vel.xz * dt;
+    else pos.y = max(pos.y, pad.x);
+    if (depth > 0.0) vel -= min(dot(vel, pad.yzw), 0.0) * dustBounce * pad.yzw;
+    float life = inPosLife.w - dt;
+
+    outPosLife = vec4(pos, life);
+    outVelMaxLife = vec4(vel, inVelMaxLife.w);
+    outNoise = inNoise;
+    outShape = inShape;
+    if (life <= 0.0 && next01() < respawnChance) respawn();
+}
+#else
+void respawn() {
+    float radial = range(0.0, flameSpread);
+    float theta = range(0.0, 2.0 * PI);
+    vec2 spread = vec2(cos(theta), sin(theta)) * radial;
+    vec3 pos = vec3(offset.x + spread.x, spawnY, offset.y + spread.y);
+    float downward = range(flameDownward - 1.0, flameDownward + 1.5);
+    vec3 vel = vec3(spread.x * flameHorizontalScale + gimbalSin.x * downward * 0.15,
+                    -downward,
+                    spread.y * flameHorizontalScale + gimbalSin.y * downward * 0.15);
+    float maxLife = range(flameLifeMin, flameLifeMin + 0.35);
+    float size = range(flameSizeBase * 0.9, flameSizeBase * 1.2);
+    float noisePhase = range(0.0, 2.0 * PI);
+    float noiseSpeed = range(1.5, 3.5);
+    float noiseTheta = range(0.0, 2.0 * PI);
+    outPosLife = vec4(pos, maxLife);
+    outVelMaxLife = vec4(vel, maxLife);
+    outNoise = vec4(noisePhase, noiseSpeed, cos(noiseTheta), sin(noiseTheta));
+    outShape = vec4(size, 0.0, 0.0, 0.0);
+}
+
+void main() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);   // required before GLSL 1.40; nothing is rasterized
+    rngState = pcgHash(uint(gl_VertexID) ^ pcgHash(step ^ pcgHash(seed)));
+    vec3 vel = inVelMaxLife.xyz;
+    float wobble = sin(inNoise.x + time * inNoise.y) * (0.01 + 0.025 * (1.0 - throttle));
+    vel.xz = (vel.xz + inNoise.zw * wobble) * (1.0 - (0.1 + 0.15 * throttle) * dt);
+    vel.y += (0.35 + 0.6 * (1.0 - throttle)) * dt;
+    vec3 pos = inPosLife.xyz + vel * dt;
+    float ground = padCell(pos.xz).x;
+    float life = pos.y < ground + recycleHeight ? 0.0 : inPosLife.w - dt;
+    pos.y = max(pos.y, ground);
+
+    outPosLife = vec4(pos, life);
+    outVelMaxLife = vec4(vel, inVelMaxLife.w);
+    outNoise = inNoise;
+    outShape = inShape;
+    if (life <= 0.0) respawn();
+}
+#endif
+)";
+
+const char *GPU_SPRITE_VERTEX_SHADER = R"(#version 120
+attribute vec2 corner;
+attribute vec4 posLife;
+attribute vec4 velMaxLife;
+attribute vec4 shape;
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+uniform vec3 tint;
+uniform vec3 dustColor;
+varying vec2 texCoord;
+varying vec4 spriteColor;
+void main() {
+    float ratio = posLife.w / max(velMaxLife.w, 1e-6);
+#ifdef DUST_POOL
+    float alpha = clamp(0.55 * ratio, 0.0, 1.0);
+    float size = shape.x * 1.6;
+#else
+    float alpha = clamp(1.1 * ratio, 0.0, 1.0);
+    float size = shape.x;
+#endif
+    texCoord = corner * 0.5 + 0.5;
+    if (alpha <= 0.01) {        // dead or faded: park the quad outside the clip volume
+        spriteColor = vec4(0.0);
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+#ifdef DUST_POOL
+    spriteColor = vec4(dustColor, alpha);
+#else
+    ratio = clamp(ratio, 0.0, 1.0);
+    vec3 fire = ratio > 0.5 ? mix(vec3(1.0, 0.4, 0.1), vec3(1.0, 0.9, 0.3), ratio * 2.0 - 1.0)
+                            : mix(vec3(0.2, 0.1, 0.05), vec3(1.0, 0.4, 0.1), ratio * 2.0);
+    spriteColor = vec4(clamp(fire * vec3(0.65, 0.7, 0.6) + tint * vec3(0.35, 0.3, 0.4), 0.0, 1.0), alpha);
+#endif
+
+    vec3 offset = (cameraRight * corner.x + cameraUp * corner.y) * (0.5 * size);
+    vec4 eye = gl_ModelViewMatrix * vec4(posLife.xyz + offset, 1.0);
+    gl_Position = gl_ProjectionMatrix * eye;
+    gl_FogFragCoord = abs(eye.z);
+}
+)";
+
+struct GpuParticlePool {
+    GLuint simProgram = 0;
+    GLuint drawProgram = 0;
+    GLuint buffers[2] = {};
+    int    current = 0;              // buffer holding the latest state
+    int    count = 0;
+    GLint  simAttrib[4] = { -1, -1, -1, -1 };   // posLife, velMaxLife, noise, shape
+    GLint  locDt = -1, locTime = -1, locThrottle = -1, locSpawnY = -1, locGimbalSin = -1, locOffset = -1;
+    GLint  locRespawn = -1, locSeed = -1, locStep = -1, locPadGrid = -1;
+    GLint  locFlameSpread = -1, locFlameDownward = -1, locFlameHorizontalScale = -1;
+    GLint  locFlameLifeMin = -1, locFlameSizeBase = -1;
+    GLint  drawCorner = -1, drawPosLife = -1, drawVelMaxLife = -1, drawShape = -1;
+    GLint  locRight = -1, locUp = -1, locTint = -1, locDustColor = -1, locFog = -1;
+};
+
+struct GpuParticleSystem {
+    bool   supported = false;
+    GpuParticlePool pools[PARTICLE_KIND_COUNT];
+    GLuint padTexture = 0;           // g_padField, bound on unit 1 while stepping
+    std::uint32_t step = 0;
+};
+
+GpuParticleSystem g_gpuParticles;
+
+// Builds one pool's programs and looks up their inputs; false if anything is missing.
+static bool initGpuParticlePool(GpuParticlePool &P, ParticleKind kind) {
+    const char *define = (kind == PARTICLE_DUST) ? "DUST_POOL" : nullptr;
+    GLuint sim = compileShaderSource(PARTICLE_SIM_SHADER, GL_VERTEX_SHADER, "Particle simulation", define);
+    if (!sim) return false;
+    P.simProgram = linkProgram({ sim }, "Particle simulation", "inPosLife",
+                               { "outPosLife", "outVelMaxLife", "outNoise", "outShape" });
+    GLuint vs = compileShaderSource(GPU_SPRITE_VERTEX_SHADER, GL_VERTEX_SHADER, "GPU particle sprite vertex", define);
+    GLuint fs = compileShaderSource(SPRITE_FRAGMENT_SHADER, GL_FRAGMENT_SHADER, "GPU particle sprite fragment");
+    if (vs && fs) {
+        P.drawProgram = linkProgram({ vs, fs }, "GPU particle sprite", "corner");
+    } else {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+    }
+    if (!P.simProgram || !P.drawProgram) return false;
+
+    // Inputs a variant never reads (noise and the flame uniforms in the dust shader) come back as
+    // -1 and are skipped.
+    const char *simInputs[4] = { "inPosLife", "inVelMaxLife", "inNoise", "inShape" };
+    for (int a = 0; a < 4; ++a) P.simAttrib[a] = glGetAttribLocation(P.simProgram, simInputs[a]);
+    P.locDt        = glGetUniformLocation(P.simProgram, "dt");
+    P.locTime      = glGetUniformLocation(P.simProgram, "time");
+    P.locThrottle  = glGetUniformLocation(P.simProgram, "throttle");
+    P.locSpawnY    = glGetUniformLocation(P.simProgram, "spawnY");
+    P.locFlameSpread          = glGetUniformLocation(P.simProgram, "flameSpread");
+    P.locFlameDownward        = glGetUniformLocation(P.simProgram, "flameDownward");
+    P.locFlameHorizontalScale = glGetUniformLocation(P.simProgram, "flameHorizontalScale");
+    P.locFlameLifeMin         = glGetUniformLocation(P.simProgram, "flameLifeMin");
+    P.locFlameSizeBase        = glGetUniformLocation(P.simProgram, "flameSizeBase");
+    P.locGimbalSin = glGetUniformLocation(P.simProgram, "gimbalSin");
+    P.locOffset    = glGetUniformLocation(P.simProgram, "offset");
+    P.locRespawn   = glGetUniformLocation(P.simProgram, "respawnChance");
+    P.locSeed      = glGetUniformLocation(P.simProgram, "seed");
+    P.locStep      = glGetUniformLocation(P.simProgram, "step");
+    P.locPadGrid   = glGetUniformLocation(P.simProgram, "padGrid");
+
+    P.drawCorner     = glGetAttribLocation(P.drawProgram, "corner");
+    P.drawPosLife    = glGetAttribLocation(P.drawProgram, "posLife");
+    P.drawVelMaxLife = glGetAttribLocation(P.drawProgram, "velMaxLife");
+    P.drawShape      = glGetAttribLocation(P.drawProgram, "shape");
+    P.locRight       = glGetUniformLocation(P.drawProgram, "cameraRight");
+    P.locUp          = glGetUniformLocation(P.drawProgram, "cameraUp");
+    P.locTint        = glGetUniformLocation(P.drawProgram, "tint");
+    P.locDustColor   = glGetUniformLocation(P.drawProgram, "dustColor");
+    P.locFog         = glGetUniformLocation(P.drawProgram, "fogEnabled");
+    if (P.simAttrib[0] < 0 || P.simAttrib[1] < 0 || P.simAttrib[3] < 0) return false;
+    if (P.drawCorner < 0 || P.drawPosLife < 0 || P.drawVelMaxLife < 0 || P.drawShape < 0) return false;
+    glUseProgram(P.simProgram);
+    glUniform1i(glGetUniformLocation(P.simProgram, "padField"), 1);
+    glUniform3f(P.locPadGrid, PAD_FIELD_HALF_EXTENT, 1.0f / PAD_FIELD_CELL, PAD_FIELD_SIZE - 1.0f);
+    glUniform1f(glGetUniformLocation(P.simProgram, "padStepHeight"), PAD_STEP_HEIGHT);
+    glUniform1f(glGetUniformLocation(P.simProgram, "dustBounce"), 1.0f + DustEmitter::RESTITUTION);
+    glUniform1f(glGetUniformLocation(P.simProgram, "recycleHeight"), FlameEmitter::RECYCLE_HEIGHT);
+    glUseProgram(P.drawProgram);
+    glUniform1i(glGetUniformLocation(P.drawProgram, "spriteTexture"), 0);
+    glUseProgram(0);
+
+    glGenBuffers(2, P.buffers);
+    return true;
+}
+
+void initGpuParticles() {
+    GpuParticleSystem &G = g_gpuParticles;
+    if (!g_spriteRing.supported) return;
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        if (!initGpuParticlePool(G.pools[kind], (ParticleKind)kind)) return;
+    }
+    // PadCell is height + normal, so the field uploads as-is; texelFetch needs no filtering.
+    if (g_padField.empty()) buildPadHeightfield();
+    glGenTextures(1, &G.padTexture);
+    glBindTexture(GL_TEXTURE_2D, G.padTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, PAD_FIELD_SIZE, PAD_FIELD_SIZE, 0, GL_RGBA, GL_FLOAT, g_padField.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glBindTexture(GL_TEXTURE_2D, 0);
-    glPopAttrib();
+    G.supported = true;
+    if (g_particleBackend == PARTICLES_GPU) uploadGpuParticles();
+}
+
+// Copies the CPU particle arrays into the GPU state (start-up, count changes, switching to GPU).
+void uploadGpuParticles() {
+    GpuParticleSystem &G = g_gpuParticles;
+    if (!G.supported) return;
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        GpuParticlePool &P = G.pools[kind];
+        const ParticleSoA &ps = g_pools[kind].particles;
+        std::vector<GpuParticle> records(ps.count);
+        for (int i = 0; i < ps.count; ++i) {
+            GpuParticle &r = records[i];
+            r.posLife[0] = ps.posX[i];   r.posLife[1] = ps.posY[i];   r.posLife[2] = ps.posZ[i];   r.posLife[3] = ps.life[i];
+            r.velMaxLife[0] = ps.velX[i]; r.velMaxLife[1] = ps.velY[i]; r.velMaxLife[2] = ps.velZ[i]; r.velMaxLife[3] = ps.maxLife[i];
+            r.noise[0] = ps.noisePhase[i]; r.noise[1] = ps.noiseSpeed[i]; r.noise[2] = ps.noiseDirX[i]; r.noise[3] = ps.noiseDirZ[i];
+            r.shape[0] = ps.size[i];     r.shape[1] = 0.0f;           r.shape[2] = 0.0f;           r.shape[3] = 0.0f;
+        }
+        GLsizeiptr bytes = (GLsizeiptr)records.size() * (GLsizeiptr)sizeof(GpuParticle);
+        P.current = 0;
+        P.count = ps.count;
+        glBindBuffer(GL_ARRAY_BUFFER, P.buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, bytes, records.data(), GL_DYNAMIC_COPY);
+        glBindBuffer(GL_ARRAY_BUFFER, P.buffers[1]);
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_DYNAMIC_COPY);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Copies the GPU state back so the CPU backend carries on where the GPU left off.
+static void readbackGpuParticles() {
+    GpuParticleSystem &G = g_gpuParticles;
+    if (!G.supported) return;
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        const GpuParticlePool &P = G.pools[kind];
+        ParticleSoA &ps = g_pools[kind].particles;
+        if (P.count != ps.count) continue;
+        std::vector<GpuParticle> records(P.count);
+        glBindBuffer(GL_ARRAY_BUFFER, P.buffers[P.current]);
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)records.size() * (GLsizeiptr)sizeof(GpuParticle), records.data());
+        for (int i = 0; i < ps.count; ++i) {
+            const GpuParticle &r = records[i];
+            ps.posX[i] = r.posLife[0];    ps.posY[i] = r.posLife[1];    ps.posZ[i] = r.posLife[2];    ps.life[i] = r.posLife[3];
+            ps.velX[i] = r.velMaxLife[0]; ps.velY[i] = r.velMaxLife[1]; ps.velZ[i] = r.velMaxLife[2]; ps.maxLife[i] = r.velMaxLife[3];
+            ps.noisePhase[i] = r.noise[0]; ps.noiseSpeed[i] = r.noise[1]; ps.noiseDirX[i] = r.noise[2]; ps.noiseDirZ[i] = r.noise[3];
+            ps.size[i] = r.shape[0];
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void bindGpuParticleAttribs(const GLint attribs[4], GLuint divisor) {
+    for (int a = 0; a < 4; ++a) {
+        if (attribs[a] < 0) continue;
+        glEnableVertexAttribArray(attribs[a]);
+        glVertexAttribPointer(attribs[a], 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle),
+                              (const void *)(a * 4 * sizeof(float)));
+        glVertexAttribDivisor(attribs[a], divisor);
+    }
+}
+
+static void unbindGpuParticleAttribs(const GLint attribs[4]) {
+    for (int a = 0; a < 4; ++a) {
+        if (attribs[a] < 0) continue;
+        glVertexAttribDivisor(attribs[a], 0);
+        glDisableVertexAttribArray(attribs[a]);
+    }
+}
+
+static void stepGpuParticlePool(GpuParticlePool &P, int kind, const EmitterState &e) {
+    if (P.count == 0) return;
+    const GpuParticleSystem &G = g_gpuParticles;
+
+    glUseProgram(P.simProgram);
+    glUniform1f(P.locDt, e.dt);
+    glUniform1f(P.locTime, e.time);
+    glUniform1f(P.locThrottle, e.throttle);
+    glUniform1f(P.locSpawnY, e.flameSpawnY);
+    glUniform1f(P.locFlameSpread, e.flameSpread);
+    glUniform1f(P.locFlameDownward, e.flameDownward);
+    glUniform1f(P.locFlameHorizontalScale, e.flameHorizontalScale);
+    glUniform1f(P.locFlameLifeMin, e.flameLifeMin);
+    glUniform1f(P.locFlameSizeBase, e.flameSizeBase);
+    glUniform2f(P.locGimbalSin, e.gimbalSinRoll, e.gimbalSinPitch);
+    glUniform2f(P.locOffset, e.baseX, e.baseZ);
+    glUniform1f(P.locRespawn, g_emitters[kind].respawnChance(e));
+    glUniform1ui(P.locSeed, (GLuint)(g_particleSeed ^ (g_particleSeed >> 32)) + (GLuint)kind * 0x9E3779B9u);
+    glUniform1ui(P.locStep, G.step);
+
+    glBindBuffer(GL_ARRAY_BUFFER, P.buffers[P.current]);
+    bindGpuParticleAttribs(P.simAttrib, 0);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, P.buffers[1 - P.current]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, P.count);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    unbindGpuParticleAttribs(P.simAttrib);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+    P.current = 1 - P.current;
+}
+
+// Same scheduling as the CPU path: idle pools are skipped.
+void stepGpuParticles(const EmitterState &e) {
+    GpuParticleSystem &G = g_gpuParticles;
+    if (!G.supported) return;
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, G.padTexture);
+    for (int kind = 0; kind < PARTICLE_KIND_COUNT; ++kind) {
+        if (particlePoolActive(kind)) stepGpuParticlePool(G.pools[kind], kind, e);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    ++G.step;
+}
+
+static void drawGpuParticlePool(const GpuParticlePool &P, int kind, const float right[3], const float up[3]) {
+    if (P.count == 0) return;
+    const EmitterState &e = g_emitterState;
+
+    applyParticleBlend(g_emitters[kind].additive);
+    glUseProgram(P.drawProgram);
+    glUniform3fv(P.locRight, 1, right);
+    glUniform3fv(P.locUp, 1, up);
+    glUniform3fv(P.locTint, 1, e.tint);
+    glUniform3fv(P.locDustColor, 1, e.dustColor);
+    glUniform1i(P.locFog, g_fogEnabled ? 1 : 0);
+
+    const GLint attribs[4] = { P.drawPosLife, P.drawVelMaxLife, -1, P.drawShape };
+    glBindBuffer(GL_ARRAY_BUFFER, P.buffers[P.current]);
+    bindGpuParticleAttribs(attribs, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, g_spriteRing.cornerBuffer);
+    glEnableVertexAttribArray(P.drawCorner);
+    glVertexAttribPointer(P.drawCorner, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, P.count);
+
+    glDisableVertexAttribArray(P.drawCorner);
+    unbindGpuParticleAttribs(attribs);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
+
+static void drawGpuParticles(const float right[3], const float up[3]) {
+    GpuParticleSystem &G = g_gpuParticles;
+    if (!G.supported) return;
+    int order[PARTICLE_KIND_COUNT];
+    int pools = particleDrawOrder(order);
+    for (int k = 0; k < pools; ++k) drawGpuParticlePool(G.pools[order[k]], order[k], right, up);
+}
+
+void setParticleBackend(ParticleBackend backend) {
+    if (backend == g_particleBackend) return;
+    if (backend == PARTICLES_GPU) {
+        if (!g_gpuParticles.supported) {
+            std::fprintf(stderr, "GPU particles need OpenGL 3.3 with transform feedback; staying on the CPU\n");
+            return;
+        }
+        uploadGpuParticles();
+    } else {
+        readbackGpuParticles();
+    }
+    g_particleBackend = backend;
+}
+#else
+void initGpuParticles() {}
+void uploadGpuParticles() {}
+void stepGpuParticles(const EmitterState &) {}
+static void drawGpuParticles(const float *, const float *) {}
+void setParticleBackend(ParticleBackend) {
+    std::fprintf(stderr, "GPU particles are not available in this build; staying on the CPU\n");
+}
+#endif
+
+static void drawImmediateSprites(const SpriteRecord *records, int count, const float right[3], const float up[3]) {
+    glBegin(GL_QUADS);
+    for (int k = 0; k < count; ++k) {
+        const SpriteRecord &rec = records[k];
+        glColor4ubv(rec.rgba);
+
+        float half = rec.size * 0.5f;
+        float rx = right[0] * half;
+        float ry = right[1] * half;
+        float rz = right[2] * half;
+        float ux = up[0] * half;
+        float uy = up[1] * half;
+        float uz = up[2] * half;
+
+        glTexCoord2f(0.0f, 1.0f); glVertex3f(rec.x - rx + ux, rec.y - ry + uy, rec.z - rz + uz);
+        glTexCoord2f(1.0f, 1.0f); glVertex3f(rec.x + rx + ux, rec.y + ry + uy, rec.z + rz + uz);
+        glTexCoord2f(1.0f, 0.0f); glVertex3f(rec.x + rx - ux, rec.y + ry - uy, rec.z + rz - uz);
+        glTexCoord2f(0.0f, 0.0f); glVertex3f(rec.x - rx - ux, rec.y - ry - uy, rec.z - rz - uz);
+    }
+    glEnd();
+}
+
+// Renders every active pool with its emitter's blend mode, alpha-blended pools first so the
+// additive flame adds over the dust. Colours come from the last captured EmitterState.
+void drawParticles() {
+    if (!g_particlesInitialized || !g_showParticles) return;
+
+    cachedPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_CULL_FACE);   // camera-facing sprites; the quads below wind clockwise on screen
+    cachedEnable(GL_TEXTURE_2D);
+    cachedBindTexture(g_particleTexture);
+
+    float mv[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, mv);
+    float right[3] = { mv[0], mv[4], mv[8] };
+    float up[3]    = { mv[1], mv[5], mv[9] };
+    const float viewZ[4] = { mv[2], mv[6], mv[10], mv[14] };
+    normalizeVec(right);
+    normalizeVec(up);
+
+    if (g_particleBackend == PARTICLES_GPU) {
+        drawGpuParticles(right, up);
+    } else if (!drawParticleSprites(right, up, viewZ)) {
+        g_spriteScratch.resize(spriteRecordCapacity());
+        SpriteBatches batches;
+        writeAllSpriteRecords(batches, viewZ, g_spriteScratch.data());
+        for (int k = 0; k < batches.pools; ++k) {
+            int kind = batches.order[k];
+            if (batches.count[kind] == 0) continue;
+            applyParticleBlend(g_emitters[kind].additive);
+            drawImmediateSprites(&g_spriteScratch[batches.first[kind]], batches.count[kind], right, up);
+        }
+    }
+
+    cachedBindTexture(0);
+    cachedPopAttrib();
 }
 
 // ------------------------------------------------------------
@@ -1495,10 +3536,10 @@ void drawEngineFlame() {
     float colorG = 0.8f * warm + 0.9f * cold;
     float colorB = 0.3f * warm + 0.9f * cold;
 
-    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
+    cachedPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
     glDisable(GL_LIGHTING);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE);
+    blendEffectLayer(GL_ONE, GL_ONE);
     glColor4f(1.0f, colorG, colorB, 0.95f);
 
     glPushMatrix();
@@ -1511,7 +3552,262 @@ void drawEngineFlame() {
     drawOpenCone(baseRadius, length, 32);
     glPopMatrix();
 
-    glPopAttrib();
+    cachedPopAttrib();
+}
+
+// ------------------------------------------------------------
+// Reduced-resolution effects target
+// ------------------------------------------------------------
+
+// H (or --half-res-effects) draws the particles and the flame cone into an offscreen target of
+// 1/EFFECTS_SCALE the viewport per axis, which cuts their blending and fill cost by the square
+// of that. The scene depth is copied once, reduced to the farthest depth of each block for the
+// target's depth test, and used again at full resolution when compositing: every pixel mixes
+// its four nearest low-resolution texels bilinearly, weighted down by how far each texel's
+// depth is from its own, so silhouettes in front of the plume stay sharp instead of haloing.
+constexpr int EFFECTS_SCALE = 2;
+bool g_halfResEffects = false;
+
+#if DUSK_GL3_API
+const char *EFFECTS_QUAD_VERTEX_SHADER = R"(#version 130
+void main() {
+    gl_Position = gl_Vertex;
+}
+)";
+
+const char *EFFECTS_DOWNSAMPLE_SHADER = R"(#version 130
+uniform sampler2D sceneDepth;
+uniform int scale;
+void main() {
+    ivec2 base = ivec2(gl_FragCoord.xy) * scale;
+    ivec2 last = textureSize(sceneDepth, 0) - 1;
+    float depth = 0.0;
+    for (int y = 0; y < scale; ++y)
+        for (int x = 0; x < scale; ++x)
+            depth = max(depth, texelFetch(sceneDepth, min(base + ivec2(x, y), last), 0).r);
+    gl_FragDepth = depth;
+}
+)";
+
+const char *EFFECTS_COMPOSITE_SHADER = R"(#version 130
+uniform sampler2D effects;        // rgb: premultiplied light, a: transmittance
+uniform sampler2D effectsDepth;
+uniform sampler2D sceneDepth;
+uniform int scale;
+uniform vec2 clipRange;           // near, far
+float eyeDepth(float d) {
+    return clipRange.x * clipRange.y / (clipRange.y - d * (clipRange.y - clipRange.x));
+}
+void main() {
+    float z = eyeDepth(texelFetch(sceneDepth, ivec2(gl_FragCoord.xy), 0).r);
+    vec2 low = gl_FragCoord.xy / float(scale) - 0.5;
+    ivec2 origin = ivec2(floor(low));
+    ivec2 last = textureSize(effects, 0) - 1;
+    vec2 f = low - floor(low);
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            ivec2 texel = clamp(origin + ivec2(x, y), ivec2(0), last);
+            float bilinear = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y) + 1e-4;
+            float gap = abs(eyeDepth(texelFetch(effectsDepth, texel, 0).r) - z) / z;
+            float w = bilinear / (0.02 + gap);
+            sum += w * texelFetch(effects, texel, 0);
+            weightSum += w;
+        }
+    }
+    gl_FragColor = sum / weightSum;
+}
+)";
+
+struct EffectsTarget {
+    bool   supported = false;        // GL 3.0 and both programs linked
+    GLuint fbo = 0;
+    GLuint color = 0;                // low resolution, RGBA16F
+    GLuint depth = 0;                // low resolution, farthest scene depth per block
+    GLuint sceneDepth = 0;           // full-resolution copy of the scene depth
+    GLuint downsampleProgram = 0, compositeProgram = 0;
+    GLint  locDownsampleScale = -1, locCompositeScale = -1, locClipRange = -1;
+    int    width = 0, height = 0;    // full-resolution size the textures were made for
+    int    lowWidth = 0, lowHeight = 0;
+    GLint  viewport[4] = {};
+    GLint  sceneFramebuffer = 0;     // bound again by the composite
+};
+
+EffectsTarget g_effectsTarget;
+
+static GLuint linkEffectsProgram(const char *fragmentSource, const char *debugName) {
+    GLuint vs = compileShaderSource(EFFECTS_QUAD_VERTEX_SHADER, GL_VERTEX_SHADER, debugName);
+    GLuint fs = compileShaderSource(fragmentSource, GL_FRAGMENT_SHADER, debugName);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return 0;
+    }
+    return linkProgram({ vs, fs }, debugName);
+}
+
+void initEffectsTarget() {
+    EffectsTarget &T = g_effectsTarget;
+    const char *version = (const char *)glGetString(GL_VERSION);
+    int major = 0;
+    if (version) std::sscanf(version, "%d", &major);
+    if (major < 3) {
+        if (g_halfResEffects) std::fprintf(stderr, "Half-resolution effects need OpenGL 3.0, drawing at full resolution\n");
+        return;
+    }
+    T.downsampleProgram = linkEffectsProgram(EFFECTS_DOWNSAMPLE_SHADER, "Effects depth downsample");
+    T.compositeProgram  = linkEffectsProgram(EFFECTS_COMPOSITE_SHADER, "Effects composite");
+    if (!T.downsampleProgram || !T.compositeProgram) return;
+
+    T.locDownsampleScale = glGetUniformLocation(T.downsampleProgram, "scale");
+    T.locCompositeScale  = glGetUniformLocation(T.compositeProgram, "scale");
+    T.locClipRange       = glGetUniformLocation(T.compositeProgram, "clipRange");
+    glUseProgram(T.downsampleProgram);
+    glUniform1i(glGetUniformLocation(T.downsampleProgram, "sceneDepth"), 1);
+    glUseProgram(T.compositeProgram);
+    glUniform1i(glGetUniformLocation(T.compositeProgram, "sceneDepth"), 1);
+    glUniform1i(glGetUniformLocation(T.compositeProgram, "effectsDepth"), 2);
+    glUniform1i(glGetUniformLocation(T.compositeProgram, "effects"), 3);
+    glUseProgram(0);
+    glGenFramebuffers(1, &T.fbo);
+    T.supported = true;
+}
+
+// Nearest-sampled, edge-clamped storage on texture unit `unit` (left active: callers go back to 0).
+static void allocEffectsTexture(GLuint &texture, int unit, GLint internalFormat, int w, int h,
+                                GLenum format, GLenum type) {
+    if (!texture) glGenTextures(1, &texture);
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, format, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+// (Re)creates the textures when the viewport size changes; false if the FBO is incomplete.
+static bool resizeEffectsTarget(int w, int h) {
+    EffectsTarget &T = g_effectsTarget;
+    if (w == T.width && h == T.height) return true;
+    T.width = w;
+    T.height = h;
+    T.lowWidth  = (w + EFFECTS_SCALE - 1) / EFFECTS_SCALE;
+    T.lowHeight = (h + EFFECTS_SCALE - 1) / EFFECTS_SCALE;
+    allocEffectsTexture(T.sceneDepth, 1, GL_DEPTH_COMPONENT24, w, h, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+    allocEffectsTexture(T.depth, 2, GL_DEPTH_COMPONENT24, T.lowWidth, T.lowHeight, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+    allocEffectsTexture(T.color, 3, GL_RGBA16F, T.lowWidth, T.lowHeight, GL_RGBA, GL_FLOAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    GLint previous = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+    glBindFramebuffer(GL_FRAMEBUFFER, T.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, T.color, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, T.depth, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, previous);
+    if (!complete) {
+        std::fprintf(stderr, "Effects target framebuffer incomplete, drawing effects at full resolution\n");
+        T.supported = false;
+    }
+    return complete;
+}
+
+static void bindEffectsTextures(bool bind) {
+    const EffectsTarget &T = g_effectsTarget;
+    const GLuint textures[3] = { T.sceneDepth, T.depth, T.color };
+    for (int k = 0; k < 3; ++k) {
+        glActiveTexture(GL_TEXTURE1 + k);
+        glBindTexture(GL_TEXTURE_2D, bind ? textures[k] : 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+static void drawEffectsQuad() {
+    glBegin(GL_TRIANGLES);   // one triangle covering the viewport
+    glVertex2f(-1.0f, -1.0f);
+    glVertex2f( 3.0f, -1.0f);
+    glVertex2f(-1.0f,  3.0f);
+    glEnd();
+}
+
+// Copies and reduces the scene depth, then leaves the cleared low-resolution target bound with
+// depth writes off. Only when it returns true must compositeEffectsTarget() follow the layers.
+static bool beginEffectsTarget() {
+    EffectsTarget &T = g_effectsTarget;
+    if (!T.supported) return false;
+    glGetIntegerv(GL_VIEWPORT, T.viewport);
+    if (!resizeEffectsTarget(T.viewport[2], T.viewport[3])) return false;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &T.sceneFramebuffer);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, T.sceneDepth);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, T.viewport[0], T.viewport[1], T.width, T.height);
+    glActiveTexture(GL_TEXTURE0);
+
+    // popped by compositeEffectsTarget()
+    cachedPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_VIEWPORT_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, T.fbo);
+    glViewport(0, 0, T.lowWidth, T.lowHeight);
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_ALWAYS);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDisable(GL_CULL_FACE);
+    glUseProgram(T.downsampleProgram);
+    glUniform1i(T.locDownsampleScale, EFFECTS_SCALE);
+    drawEffectsQuad();
+    glUseProgram(0);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_CULL_FACE);
+    g_effectsOffscreen = true;
+    return true;
+}
+
+// Lays the target over the scene framebuffer: scene * transmittance + light.
+static void compositeEffectsTarget() {
+    EffectsTarget &T = g_effectsTarget;
+    g_effectsOffscreen = false;
+    glBindFramebuffer(GL_FRAMEBUFFER, T.sceneFramebuffer);
+    glViewport(T.viewport[0], T.viewport[1], T.viewport[2], T.viewport[3]);
+
+    // near and far back out of the perspective projection
+    float proj[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, proj);
+    float clipRange[2] = { proj[14] / (proj[10] - 1.0f), proj[14] / (proj[10] + 1.0f) };
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_SRC_ALPHA);
+    bindEffectsTextures(true);
+    glUseProgram(T.compositeProgram);
+    glUniform1i(T.locCompositeScale, EFFECTS_SCALE);
+    glUniform2fv(T.locClipRange, 1, clipRange);
+    drawEffectsQuad();
+    glUseProgram(0);
+    bindEffectsTextures(false);
+    cachedPopAttrib();
+}
+#else
+void initEffectsTarget() {}
+static bool beginEffectsTarget() { return false; }
+static void compositeEffectsTarget() {}
+#endif
+
+static const char *effectsResolutionName() {
+#if DUSK_GL3_API
+    if (g_halfResEffects && g_effectsTarget.supported) return "half res";
+#endif
+    return g_halfResEffects ? "full res (no GL 3)" : "full res";
 }
 
 // ------------------------------------------------------------
@@ -1520,6 +3816,137 @@ void drawEngineFlame() {
 
 constexpr std::size_t HUD_BUFFER_SIZE = 128;
 
+// Glyph atlas: both HUD fonts are rasterized once (through glutBitmapCharacter into an
+// offscreen framebuffer) into one alpha texture of 24x24 cells, so a frame's HUD text is a
+// single textured-quad draw. Falls back to glutBitmapCharacter if the atlas can't be built.
+enum HudFont { HUD_FONT_SMALL = 0, HUD_FONT_TITLE, HUD_FONT_COUNT };
+
+constexpr int ATLAS_FIRST_CHAR = 32;
+constexpr int ATLAS_CHAR_COUNT = 95;      // printable ASCII
+constexpr int ATLAS_CELL       = 24;
+constexpr int ATLAS_COLS       = 16;
+constexpr int ATLAS_ROWS       = 12;      // 6 rows per font
+constexpr int ATLAS_PAD_X      = 2;       // glyph origin inside its cell
+constexpr int ATLAS_BASELINE   = 6;
+
+struct TextAtlas {
+    GLuint texture = 0;
+    float  advance[HUD_FONT_COUNT][ATLAS_CHAR_COUNT] = {};
+};
+
+TextAtlas g_textAtlas;
+
+static void *hudFontHandle(int font) {
+    return font == HUD_FONT_TITLE ? GLUT_BITMAP_HELVETICA_18 : GLUT_BITMAP_HELVETICA_12;
+}
+
+void buildTextAtlas() {
+    TextAtlas &a = g_textAtlas;
+    const int W = ATLAS_COLS * ATLAS_CELL;
+    const int H = ATLAS_ROWS * ATLAS_CELL;
+
+    GLuint target = 0, fbo = 0;
+    glGenTextures(1, &target);
+    cachedBindTexture(target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    cachedBindTexture(0);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    std::vector<GLubyte> rgba;
+    if (complete) {
+        cachedPushAttrib(GL_ENABLE_BIT | GL_VIEWPORT_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_LIGHTING);
+        cachedDisable(GL_TEXTURE_2D);
+        glDisable(GL_FOG);
+        glViewport(0, 0, W, H);
+        glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity();
+        gluOrtho2D(0, W, 0, H);
+        glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity();
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glColor3f(1, 1, 1);
+        for (int f = 0; f < HUD_FONT_COUNT; ++f) {
+            for (int i = 0; i < ATLAS_CHAR_COUNT; ++i) {
+                int cell = f * (ATLAS_ROWS / 2) * ATLAS_COLS + i;
+                glRasterPos2i((cell % ATLAS_COLS) * ATLAS_CELL + ATLAS_PAD_X,
+                              (cell / ATLAS_COLS) * ATLAS_CELL + ATLAS_BASELINE);
+                glutBitmapCharacter(hudFontHandle(f), ATLAS_FIRST_CHAR + i);
+                a.advance[f][i] = (float)glutBitmapWidth(hudFontHandle(f), ATLAS_FIRST_CHAR + i);
+            }
+        }
+        rgba.resize((size_t)W * H * 4);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, W, H, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION); glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+        cachedPopAttrib();
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &target);
+    if (!complete) {
+        std::fprintf(stderr, "HUD glyph atlas unavailable, using bitmap text\n");
+        return;
+    }
+
+    // white texels, coverage in alpha, so glColor tints the text
+    for (std::size_t i = 0; i < rgba.size(); i += 4) {
+        rgba[i + 3] = rgba[i];
+        rgba[i] = rgba[i + 1] = rgba[i + 2] = 255;
+    }
+    glGenTextures(1, &a.texture);
+    cachedBindTexture(a.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    cachedBindTexture(0);
+}
+
+// One HUD line: its quads (x y s t r g b a per vertex) are laid out again only when the text,
+// position, font or color changes, so static lines cost a copy per frame.
+struct HudTextLine {
+    std::string text;
+    float x = 0.0f, y = 0.0f;
+    int font = -1;
+    float color[4] = { 0, 0, 0, 0 };
+    std::vector<GLfloat> verts;
+};
+
+std::vector<HudTextLine> g_hudLines;
+std::vector<GLfloat>     g_hudTextVerts;        // this frame's batch
+int                      g_hudLineCount  = 0;   // lines submitted this frame
+
+static void layoutHudLine(HudTextLine &line) {
+    const float invW = 1.0f / (ATLAS_COLS * ATLAS_CELL);
+    const float invH = 1.0f / (ATLAS_ROWS * ATLAS_CELL);
+    line.verts.clear();
+    float penX = std::floor(line.x + 0.5f);
+    float baseY = std::floor(line.y + 0.5f);
+    for (unsigned char c : line.text) {
+        if (c < ATLAS_FIRST_CHAR || c >= ATLAS_FIRST_CHAR + ATLAS_CHAR_COUNT) c = '?';
+        int i = c - ATLAS_FIRST_CHAR;
+        int cell = line.font * (ATLAS_ROWS / 2) * ATLAS_COLS + i;
+        float s0 = (cell % ATLAS_COLS) * ATLAS_CELL * invW, s1 = s0 + ATLAS_CELL * invW;
+        float t0 = (cell / ATLAS_COLS) * ATLAS_CELL * invH, t1 = t0 + ATLAS_CELL * invH;
+        float x0 = penX - ATLAS_PAD_X, x1 = x0 + ATLAS_CELL;
+        float y0 = baseY - ATLAS_BASELINE, y1 = y0 + ATLAS_CELL;
+        const GLfloat quad[4][4] = { { x0, y0, s0, t0 }, { x1, y0, s1, t0 }, { x1, y1, s1, t1 }, { x0, y1, s0, t1 } };
+        for (const auto &q : quad) {
+            line.verts.insert(line.verts.end(), q, q + 4);
+            line.verts.insert(line.verts.end(), line.color, line.color + 4);
+        }
+        penX += g_textAtlas.advance[line.font][i];
+    }
+}
+
 void drawBitmapString(float x, float y, void *font, const char *s) {
     glRasterPos2f(x, y);
     while (*s) {
@@ -1527,6 +3954,110 @@ void drawBitmapString(float x, float y, void *font, const char *s) {
     }
 }
 
+GLfloat g_hudColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+// Text color for following hudText calls (also the current color for the bitmap fallback).
+void hudColor(float r, float g, float b) {
+    g_hudColor[0] = r; g_hudColor[1] = g; g_hudColor[2] = b; g_hudColor[3] = 1.0f;
+    glColor3f(r, g, b);
+}
+
+// Queues HUD text in window pixels (baseline at y); the bitmap fallback draws immediately.
+void hudText(float x, float y, int font, const char *s) {
+    if (!g_textAtlas.texture) {
+        drawBitmapString(x, y, hudFontHandle(font), s);
+        return;
+    }
+    const GLfloat *color = g_hudColor;
+    if ((int)g_hudLines.size() <= g_hudLineCount) g_hudLines.resize(g_hudLineCount + 1);
+    HudTextLine &line = g_hudLines[g_hudLineCount++];
+    if (line.text != s || line.x != x || line.y != y || line.font != font ||
+        !std::equal(color, color + 4, line.color)) {
+        line.text = s; line.x = x; line.y = y; line.font = font;
+        std::copy(color, color + 4, line.color);
+        layoutHudLine(line);
+    }
+    g_hudTextVerts.insert(g_hudTextVerts.end(), line.verts.begin(), line.verts.end());
+}
+
+// Draws every line queued since the last flush in one call.
+void flushHudText() {
+    if (!g_hudTextVerts.empty()) {
+        cachedPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
+        glDisable(GL_FOG);
+        cachedEnable(GL_TEXTURE_2D);
+        cachedBindTexture(g_textAtlas.texture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        const GLsizei stride = 8 * sizeof(GLfloat);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, stride, &g_hudTextVerts[0]);
+        glTexCoordPointer(2, GL_FLOAT, stride, &g_hudTextVerts[2]);
+        glColorPointer(4, GL_FLOAT, stride, &g_hudTextVerts[4]);
+        glDrawArrays(GL_QUADS, 0, (GLsizei)(g_hudTextVerts.size() / 8));
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        cachedBindTexture(0);
+        cachedPopAttrib();
+    }
+    g_hudTextVerts.clear();
+    g_hudLineCount = 0;
+}
+
+// Per-pass breakdown in the top-right corner; queued into the same text batch as the HUD.
+void drawProfilerOverlay() {
+    const float boxW = 330.0f;
+    const float boxH = 46.0f + 18.0f * PASS_COUNT;
+    const float x0 = g_windowWidth - boxW - 10.0f;
+    const float top = g_windowHeight - 10.0f;
+
+    glColor4f(0.0f, 0.0f, 0.0f, 0.55f);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBegin(GL_QUADS);
+    glVertex2f(x0, top - boxH);
+    glVertex2f(x0 + boxW, top - boxH);
+    glVertex2f(x0 + boxW, top);
+    glVertex2f(x0, top);
+    glEnd();
+    glDisable(GL_BLEND);
+
+    char buf[HUD_BUFFER_SIZE];
+    float y = top - 20.0f;
+    hudColor(0.8f, 0.9f, 1.0f);
+    snprintf(buf, HUD_BUFFER_SIZE, "Pass              CPU ms   GPU ms%s",
+             g_profiler.captureFramesLeft > 0 ? "   [tracing]" : "");
+    hudText(x0 + 10.0f, y, HUD_FONT_SMALL, buf); y -= 18.0f;
+
+    hudColor(1.0f, 1.0f, 1.0f);
+    double cpuTotal = 0.0, gpuTotal = 0.0;
+    for (int p = 0; p < PASS_COUNT; ++p) {
+        if (!g_profiler.active[p]) {
+            snprintf(buf, HUD_BUFFER_SIZE, "%-16s %7s  %7s", g_passNames[p], "off", "off");
+            hudText(x0 + 10.0f, y, HUD_FONT_SMALL, buf); y -= 18.0f;
+            continue;
+        }
+        char gpu[16] = "--";
+        if (g_profiler.gpuValid[p]) {
+            snprintf(gpu, sizeof(gpu), "%.3f", g_profiler.gpuMs[p]);
+            gpuTotal += g_profiler.gpuMs[p];
+        }
+        cpuTotal += g_profiler.cpuMs[p];
+        snprintf(buf, HUD_BUFFER_SIZE, "%-16s %7.3f  %7s", g_passNames[p], g_profiler.cpuMs[p], gpu);
+        hudText(x0 + 10.0f, y, HUD_FONT_SMALL, buf); y -= 18.0f;
+    }
+    hudColor(0.95f, 0.9f, 0.75f);
+    snprintf(buf, HUD_BUFFER_SIZE, "total %.2f ms CPU, %.2f ms GPU  (K: trace)", cpuTotal, gpuTotal);
+    hudText(x0 + 10.0f, y, HUD_FONT_SMALL, buf);
+    hudColor(1.0f, 1.0f, 1.0f);
+}
+
+const int HUD_TELEMETRY_LINES = 15;   // between the title and the cheat sheet; sizes the box
+
 void drawHUD() {
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -1540,58 +4071,77 @@ void drawHUD() {
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_LIGHTING);
 
-    // background box
+    // background box: title, telemetry lines, cheat sheet
+    const float boxH = 56.0f + 18.0f * HUD_TELEMETRY_LINES;
     glColor4f(0.0f, 0.0f, 0.0f, 0.55f);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glBegin(GL_QUADS);
-    glVertex2f(10, g_windowHeight - 300);
-    glVertex2f(330, g_windowHeight - 300);
+    glVertex2f(10, g_windowHeight - 10 - boxH);
+    glVertex2f(330, g_windowHeight - 10 - boxH);
     glVertex2f(330, g_windowHeight - 10);
     glVertex2f(10, g_windowHeight - 10);
     glEnd();
     glDisable(GL_BLEND);
 
-    void *font = GLUT_BITMAP_HELVETICA_12;
+    const int font = HUD_FONT_SMALL;
     float y = g_windowHeight - 30;
 
-    glColor3f(0.8f, 0.9f, 1.0f);
-    drawBitmapString(20, y, GLUT_BITMAP_HELVETICA_18, "DUSK LANDING - TELEMETRY");
+    hudColor(0.8f, 0.9f, 1.0f);
+    hudText(20, y, HUD_FONT_TITLE, "DUSK LANDING - TELEMETRY");
     y -= 22;
 
     char buf[HUD_BUFFER_SIZE];
-    glColor3f(1.0f, 1.0f, 1.0f);
+    hudColor(1.0f, 1.0f, 1.0f);
 
     snprintf(buf, HUD_BUFFER_SIZE, "Time: %.2f / %.1f s", g_anim.time, g_anim.duration);
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Altitude: %.1f m", g_anim.altitude);
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Vertical Speed: %5.1f m/s", g_anim.verticalSpeed);
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     // Explicit surface cues make it obvious how much actuation remains.
     snprintf(buf, HUD_BUFFER_SIZE, "Legs: %3.0f%% deployed", g_anim.legDeploy * 100.0f);
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Gimbal: %+.1f deg", g_anim.gimbal);
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Camera: %s (C to toggle)", g_cameraMode == ORBIT_CAMERA ? "Orbit" : "Action");
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Environment: %s (E)", g_showEnvironment ? "ON" : "OFF");
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Planar Shadow: %s (P)", g_showShadow ? "ON" : "OFF");
-    drawBitmapString(20, y, font, buf); y -= 18;
-    snprintf(buf, HUD_BUFFER_SIZE, "Particles: %s (X)", g_showParticles ? "ON" : "OFF");
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
+    snprintf(buf, HUD_BUFFER_SIZE, "Particles: %s flame x%d, dust x%d%s (X, [ ])", g_showParticles ? "ON" : "OFF",
+             g_particleCount, dustCapacity(), particlePoolActive(PARTICLE_DUST) ? "" : " idle");
+    hudText(20, y, font, buf); y -= 18;
+    if (g_particleBackend == PARTICLES_GPU) {
+        snprintf(buf, HUD_BUFFER_SIZE, "Particle sim: GPU transform feedback (G)");
+        hudText(20, y, font, buf); y -= 18;
+        snprintf(buf, HUD_BUFFER_SIZE, "Sprites: drawn from the sim buffer, unsorted");
+    } else {
+        snprintf(buf, HUD_BUFFER_SIZE, "Particle sim: CPU, %d threads (G)", jobSystem().threadCount());
+        hudText(20, y, font, buf); y -= 18;
+        snprintf(buf, HUD_BUFFER_SIZE, "Sprites: %s (I) | sort: %s", particleSpritePath(),
+                 depthSortMethodName(particlePoolActive(PARTICLE_DUST) ? g_depthSort[PARTICLE_DUST].lastMethod
+                                                                       : DEPTH_SORT_NONE));
+    }
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Atmospheric Fog: %s (O)", g_fogEnabled ? "ON" : "OFF");
-    drawBitmapString(20, y, font, buf); y -= 18;
-    snprintf(buf, HUD_BUFFER_SIZE, "Engine Flame: %s (M)", g_showFlame ? "ON" : "OFF");
-    drawBitmapString(20, y, font, buf); y -= 18;
+    hudText(20, y, font, buf); y -= 18;
+    snprintf(buf, HUD_BUFFER_SIZE, "Engine Flame: %s (M) | effects: %s (H)", g_showFlame ? "ON" : "OFF",
+             effectsResolutionName());
+    hudText(20, y, font, buf); y -= 18;
     snprintf(buf, HUD_BUFFER_SIZE, "Animation: %s (1=Pause,2=Play,R=Reset)", g_anim.playing ? "PLAYING" : "PAUSED");
-    drawBitmapString(20, y, font, buf); y -= 20;
+    hudText(20, y, font, buf); y -= 18;
+    snprintf(buf, HUD_BUFFER_SIZE, "GL state calls: %d issued, %d elided", g_glStateStats.lastIssued, g_glStateStats.lastElided);
+    hudText(20, y, font, buf); y -= 20;
 
     // Quick control cheat sheet keeps graders oriented without leaving the HUD.
-    glColor3f(0.95f, 0.9f, 0.75f);
-    drawBitmapString(20, y, font, "C: toggle camera | Arrow keys: orbit | +/- or mouse wheel: zoom");
-    glColor3f(1.0f, 1.0f, 1.0f);
+    hudColor(0.95f, 0.9f, 0.75f);
+    hudText(20, y, font, "C: toggle camera | Arrow keys: orbit | +/- or mouse wheel: zoom");
+    hudColor(1.0f, 1.0f, 1.0f);
+    if (g_profiler.showOverlay) drawProfilerOverlay();
+    flushHudText();
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_LIGHTING);
@@ -1670,9 +4220,18 @@ void initGL() {
     glClearColor(0.05f, 0.07f, 0.12f, 1.0f);
 
     initTextures();
+    buildTextAtlas();
     setupLighting();
     setupFog();
     initParticles();
+    initParticleSprites();
+    initGpuParticles();
+    initEffectsTarget();
+    if (g_particleBackend == PARTICLES_GPU && !g_gpuParticles.supported) {
+        std::fprintf(stderr, "GPU particles need OpenGL 3.3 with transform feedback; using the CPU\n");
+        g_particleBackend = PARTICLES_CPU;
+    }
+    initProfiler();
 
     float aspect = (g_windowHeight == 0) ? 1.0f : (float)g_windowWidth / (float)g_windowHeight;
     glMatrixMode(GL_PROJECTION);
@@ -1796,6 +4355,9 @@ void applyCamera() {
 }
 
 void display() {
+    double frameStartUs = profilerNowUs();
+    beginGLStateFrame();
+    beginProfiledFrame();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
@@ -1804,16 +4366,24 @@ void display() {
     glEnable(GL_LIGHTING);
 
     if (g_showEnvironment) {
-        drawEnvironment();
+        {
+            ScopedPass pass(PASS_ENVIRONMENT);
+            drawEnvironment();
+        }
         if (g_anim.altitude < 12.0f) {
+            ScopedPass pass(PASS_PAD_LIGHTS);
             float intensity = 1.0f - clampFloat((g_anim.altitude - 2.0f) / 10.0f, 0.0f, 1.0f);
             drawPadLights(intensity);
         }
     }
 
-    drawBooster(false);
+    {
+        ScopedPass pass(PASS_BOOSTER);
+        drawBooster(false);
+    }
 
     if (g_showShadow) {
+        ScopedPass pass(PASS_SHADOW);
         float plane[4] = { 0.0f, 1.0f, 0.0f, 0.0f };
         float lightDir[3] = { 60.0f, 50.0f, 40.0f };
         float len = std::sqrt(lightDir[0]*lightDir[0] + lightDir[1]*lightDir[1] + lightDir[2]*lightDir[2]);
@@ -1825,7 +4395,7 @@ void display() {
         float shadowMat[16];
         computeShadowMatrix(shadowMat, plane, lightDir);
 
-        glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
+        cachedPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
         glDisable(GL_LIGHTING);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -1837,13 +4407,32 @@ void display() {
         glMultMatrixf(shadowMat);
         drawBooster(true);
         glPopMatrix();
-        glPopAttrib();
+        cachedPopAttrib();
     }
 
-    drawParticles();
-    drawEngineFlame();
-    drawHUD();
+    bool reducedEffects = false;
+    if (g_halfResEffects) {
+        ScopedPass pass(PASS_EFFECTS_DEPTH);
+        reducedEffects = beginEffectsTarget();
+    }
+    {
+        ScopedPass pass(PASS_PARTICLES);
+        drawParticles();
+    }
+    {
+        ScopedPass pass(PASS_FLAME);
+        drawEngineFlame();
+    }
+    if (reducedEffects) {
+        ScopedPass pass(PASS_EFFECTS_UPSAMPLE);
+        compositeEffectsTarget();
+    }
+    {
+        ScopedPass pass(PASS_HUD);
+        drawHUD();
+    }
 
+    endProfiledFrame(frameStartUs);
     glutSwapBuffers();
 }
 
@@ -1868,8 +4457,14 @@ void update(int value) {
     g_lastTimeMs = now;
     dt = clampFloat(dt, 0.0f, 0.1f);
 
-    g_anim.update(dt);
-    updateParticles(dt);
+    {
+        ScopedPass pass(PASS_ANIMATION, false);
+        g_anim.update(dt);
+    }
+    {
+        ScopedPass pass(PASS_PARTICLE_UPDATE, false);
+        updateParticles(dt);
+    }
 
     glutPostRedisplay();
     glutTimerFunc(16, update, 0);
@@ -1900,6 +4495,27 @@ void keyboard(unsigned char key, int, int) {
         case 'm': case 'M':
             g_showFlame = !g_showFlame;
             break;
+        case 'f': case 'F':
+            g_profiler.showOverlay = !g_profiler.showOverlay;
+            break;
+        case 'k': case 'K':
+            startTraceCapture();
+            break;
+        case 'i': case 'I':
+            g_instancedSprites = !g_instancedSprites;
+            break;
+        case 'h': case 'H':
+            g_halfResEffects = !g_halfResEffects;
+            break;
+        case 'g': case 'G':
+            setParticleBackend(g_particleBackend == PARTICLES_GPU ? PARTICLES_CPU : PARTICLES_GPU);
+            break;
+        case '[':
+            setParticleCounts(g_particleCount / 2, g_dustCount / 2);
+            break;
+        case ']':
+            setParticleCounts(g_particleCount * 2, g_dustCount * 2);
+            break;
         case '1':
             g_anim.playing = false;
             break;
@@ -1973,6 +4589,15 @@ void mouseMotion(int x, int y) {
 
 int main(int argc, char **argv) {
     glutInit(&argc, argv);
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (hasValue && std::strcmp(argv[i], "--particles") == 0) setParticleCounts(std::atoi(argv[++i]), g_dustCount);
+        else if (hasValue && std::strcmp(argv[i], "--dust") == 0) setParticleCounts(g_particleCount, std::atoi(argv[++i]));
+        else if (hasValue && std::strcmp(argv[i], "--threads") == 0) g_jobThreads = std::atoi(argv[++i]);
+        else if (hasValue && std::strcmp(argv[i], "--seed") == 0) g_particleSeed = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--gpu-particles") == 0) g_particleBackend = PARTICLES_GPU;
+        else if (std::strcmp(argv[i], "--half-res-effects") == 0) g_halfResEffects = true;
+    }
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
     glutInitWindowSize(g_windowWidth, g_windowHeight);
     glutCreateWindow("Dusk Landing - Aerospace Visualization");
@@ -6,6 +6,7 @@
 #ifdef __APPLE__
 #  include <GLUT/glut.h>
 #else
+#  define GL_GLEXT_PROTOTYPES   // buffer objects (GL 1.5) come from glext.h
 #  include <GL/glut.h>
 #endif
 
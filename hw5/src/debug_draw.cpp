@@ -0,0 +1,48 @@
+#include "debug_draw.hpp"
+#include <vector>
+
+struct DebugVertex { float p[3]; float c[3]; };
+
+static std::vector<DebugVertex> gLines;        // pairs of vertices, eye space
+static float gMV[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+static float gColor[3] = {1,1,1};
+static size_t gLastCount = 0;
+
+void debugCaptureTransform(){ glGetFloatv(GL_MODELVIEW_MATRIX, gMV); }
+
+void debugColor(float r,float g,float b){ gColor[0]=r; gColor[1]=g; gColor[2]=b; }
+
+static DebugVertex toEye(float x,float y,float z)
+{
+    DebugVertex v;
+    for(int i=0;i<3;i++) v.p[i] = gMV[i]*x + gMV[4+i]*y + gMV[8+i]*z + gMV[12+i];
+    v.c[0]=gColor[0]; v.c[1]=gColor[1]; v.c[2]=gColor[2];
+    return v;
+}
+
+void debugLine(float x0,float y0,float z0, float x1,float y1,float z1)
+{
+    gLines.push_back(toEye(x0,y0,z0));
+    gLines.push_back(toEye(x1,y1,z1));
+}
+
+void debugFlush()
+{
+    gLastCount = gLines.size()/2;
+    if (gLines.empty()) return;
+    glPushAttrib(GL_ENABLE_BIT|GL_CURRENT_BIT);
+    glDisable(GL_LIGHTING);
+    glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(DebugVertex), gLines[0].p);
+    glColorPointer (3, GL_FLOAT, sizeof(DebugVertex), gLines[0].c);
+    glDrawArrays(GL_LINES, 0, (GLsizei)gLines.size());
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+    glPopAttrib();
+    gLines.clear();                                // keeps capacity for the next frame
+}
+
+size_t debugLineCount(){ return gLastCount; }
@@ -0,0 +1,15 @@
+#pragma once
+#include "common.hpp"
+
+// Batched debug lines. Lines are transformed to eye space when they are added (by the modelview
+// captured with debugCaptureTransform) and appended to one per-frame CPU buffer; debugFlush
+// draws the whole buffer with a single unlit glDrawArrays(GL_LINES) and clears it. Safe to call
+// between glBegin/glEnd, since adding a line never touches GL state.
+
+// Reads the current GL modelview once; following lines are given in that object space.
+void debugCaptureTransform();
+void debugColor(float r,float g,float b);
+void debugLine(float x0,float y0,float z0, float x1,float y1,float z1);
+// Draws everything added this frame (under the current projection) and empties the buffer.
+void debugFlush();
+size_t debugLineCount();          // lines drawn by the last flush
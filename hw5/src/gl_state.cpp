@@ -0,0 +1,65 @@
+#include "gl_state.hpp"
+#include <algorithm>
+#include <vector>
+
+// linear lookups: a frame touches a handful of caps and parameters
+struct CapEntry   { GLenum cap; bool on; };
+struct ParamEntry { GLenum target, pname; float v[4]; };
+
+static std::vector<CapEntry>   gCaps;
+static std::vector<ParamEntry> gLights, gMaterials;
+static GLenum gShadeModel = 0;
+static GLStateStats gStats;
+
+static bool changed(bool c){ ++(c? gStats.issued : gStats.elided); return c; }
+
+static void setCap(GLenum cap, bool on)
+{
+    auto it = std::find_if(gCaps.begin(),gCaps.end(),[&](const CapEntry& e){ return e.cap==cap; });
+    if (it!=gCaps.end() && !changed(it->on!=on)) return;
+    if (it==gCaps.end()){ changed(true); gCaps.push_back({cap,on}); } else it->on = on;
+    if (on) glEnable(cap); else glDisable(cap);
+}
+
+void cachedEnable(GLenum cap){ setCap(cap,true); }
+void cachedDisable(GLenum cap){ setCap(cap,false); }
+
+void cachedShadeModel(GLenum mode)
+{
+    if (!changed(gShadeModel!=mode)) return;
+    gShadeModel = mode; glShadeModel(mode);
+}
+
+// true if (target,pname) already holds v[0..n); otherwise records v
+static bool sameParam(std::vector<ParamEntry>& tab, GLenum target, GLenum pname, const float* v, int n)
+{
+    for (auto& e : tab) if (e.target==target && e.pname==pname){
+        if (std::equal(v,v+n,e.v)) return true;
+        std::copy(v,v+n,e.v); return false;
+    }
+    ParamEntry e{target,pname,{0,0,0,0}}; std::copy(v,v+n,e.v); tab.push_back(e);
+    return false;
+}
+
+static int paramCount(GLenum pname){ return (pname==GL_SHININESS||pname==GL_SPOT_EXPONENT||pname==GL_SPOT_CUTOFF||
+                                            pname==GL_CONSTANT_ATTENUATION||pname==GL_LINEAR_ATTENUATION||
+                                            pname==GL_QUADRATIC_ATTENUATION)? 1 : (pname==GL_SPOT_DIRECTION? 3 : 4); }
+
+void cachedLightfv(GLenum light, GLenum pname, const float* v)
+{
+    const bool eyeSpace = pname==GL_POSITION || pname==GL_SPOT_DIRECTION;
+    if (!changed(eyeSpace || !sameParam(gLights,light,pname,v,paramCount(pname)))) return;
+    glLightfv(light,pname,v);
+}
+
+void cachedMaterialfv(GLenum face, GLenum pname, const float* v)
+{
+    if (!changed(!sameParam(gMaterials,face,pname,v,paramCount(pname)))) return;
+    glMaterialfv(face,pname,v);
+}
+
+void cachedMaterialf(GLenum face, GLenum pname, float v){ cachedMaterialfv(face,pname,&v); }
+
+void glStateInvalidate(){ gCaps.clear(); gLights.clear(); gMaterials.clear(); gShadeModel = 0; }
+
+GLStateStats glStateEndFrame(){ GLStateStats s = gStats; gStats = GLStateStats(); return s; }
@@ -0,0 +1,18 @@
+#pragma once
+#include "common.hpp"
+
+// Thin state cache: remembers what was last set through these calls and skips the GL call when
+// nothing would change. Only state routed through here is tracked, so anything that changes it
+// directly must restore it (glPushAttrib/glPopAttrib) or call glStateInvalidate().
+// Light positions/directions are always issued, since GL transforms them by the modelview.
+void cachedEnable(GLenum cap);
+void cachedDisable(GLenum cap);
+void cachedShadeModel(GLenum mode);
+void cachedLightfv(GLenum light, GLenum pname, const float* v);
+void cachedMaterialfv(GLenum face, GLenum pname, const float* v);
+void cachedMaterialf(GLenum face, GLenum pname, float v);
+void glStateInvalidate();
+
+struct GLStateStats { int issued=0, elided=0; };
+// Returns the counts since the previous call and starts a new frame.
+GLStateStats glStateEndFrame();
@@ -4,26 +4,41 @@
 #include "lighting.hpp"
 #include "geometry.hpp"
 #include "util.hpp"
+#include "surface_cache.hpp"
+#include "tessellation.hpp"
+#include "debug_draw.hpp"
+#include "gl_state.hpp"
 
 static CameraState cam; 
 static LightState  L;
 static int lastTime=0; // ms
+static GLStateStats glStats; // previous frame
 
 static void display()
 {
-    glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT); glEnable(GL_DEPTH_TEST);
+    glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT); cachedEnable(GL_DEPTH_TEST);
     applyProjection(cam); applyView(cam);
     setupLighting(L);
 
-    // Scene
+    // Scene (grid and normals are queued as debug lines, flushed after the solids)
     drawGrid(12,0.5);
 
-    glPushMatrix(); glTranslatef(-2.5f,1.0f,0.0f); glRotatef(90,1,0,0); glColor3f(0.8f,0.2f,0.2f); drawTorus(1.2,0.4,64,32); glPopMatrix();
-    glPushMatrix(); glTranslatef(2.2f,0.2f,-0.5f); glRotatef(-20,0,1,0); glColor3f(0.2f,0.6f,0.9f); drawHelicoid(1.5,0.25,40,80); glPopMatrix();
+    // levels are picked under the object's own modelview
+    TessLevel tl={64,32}, hl={40,80};
+    glPushMatrix(); glTranslatef(-2.5f,1.0f,0.0f); glRotatef(90,1,0,0); glColor3f(0.8f,0.2f,0.2f);
+    if(gAdaptiveTess) tl=torusTessLevel(cam,1.2,0.4);
+    drawTorus(1.2,0.4,tl.nu,tl.nv); glPopMatrix();
+    glPushMatrix(); glTranslatef(2.2f,0.2f,-0.5f); glRotatef(-20,0,1,0); glColor3f(0.2f,0.6f,0.9f);
+    if(gAdaptiveTess) hl=helicoidTessLevel(cam,1.5,0.25);
+    drawHelicoid(1.5,0.25,hl.nu,hl.nv); glPopMatrix();
     glPushMatrix(); glTranslatef(0.0f,0.8f,2.5f); glRotatef(35,0,1,0); glColor3f(0.6f,0.5f,0.4f); drawRock(1.2); glPopMatrix();
+    debugFlush();
 
-    hudPrintf(0.02f,0.96f,"th=%d ph=%d  mode=%d  light(%s)  theta=%.0f elev=%.0f",cam.th,cam.ph,cam.mode,L.enabled?"on":"off",L.theta,L.elev);
+    hudPrintf(0.02f,0.96f,"th=%d ph=%d  mode=%d fov=%d  light(%s)  theta=%.0f elev=%.0f  meshes built=%d",cam.th,cam.ph,cam.mode,cam.fov,L.enabled?"on":"off",L.theta,L.elev,surfaceCacheBuilds());
+    hudPrintf(0.02f,0.92f,"tess(%s %.2gpx)  torus %dx%d  helicoid %dx%d  debug lines=%zu",gAdaptiveTess?"adaptive":"fixed",gTessErrorPx,tl.nu,tl.nv,hl.nu,hl.nv,debugLineCount());
+    hudPrintf(0.02f,0.88f,"GL state calls: %d issued, %d elided",glStats.issued,glStats.elided);
 
+    glStats = glStateEndFrame();
     glutSwapBuffers();
 }
 
@@ -40,6 +55,9 @@ static void key(unsigned char ch,int,int)
         case '0': cam.th=cam.ph=0; break;
         case 'm': cam.mode=(cam.mode+1)%3; break;
         case 'n': gShowNormals = 1-gShowNormals; break;
+        case 'a': gAdaptiveTess = 1-gAdaptiveTess; break;
+        case '<': gTessErrorPx = (gTessErrorPx>0.125f)? gTessErrorPx*0.5f : gTessErrorPx; break;
+        case '>': gTessErrorPx = (gTessErrorPx<8.0f)? gTessErrorPx*2.0f : gTessErrorPx; break;
         case 'l': L.enabled = 1-L.enabled; break;
         case ' ': L.animate = 1-L.animate; break;
         case '[': L.theta -= 5; break; case ']': L.theta += 5; break;
@@ -0,0 +1,106 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Generic tessellator for parametric surfaces p(u,v). A surface is a small functor:
+//
+//   struct F {
+//       void operator()(float u,float v, SurfaceSample& s) const;   // position + partials
+//       void normal(float u,float v, float n[3]) const;              // optional, analytic
+//   };
+//
+// Without normal() the engine uses normalize(du x dv). Rows are evaluated into SoA scratch
+// arrays (position, then normals, then interleave) so the per-row loops stay branch-free and
+// vectorizable, and the functor inlines into them.
+//
+// hw6 builds against this copy (-I../hw5/src) and its zip target bundles it.
+
+struct SurfaceSample { float p[3], du[3], dv[3]; };
+
+// One GL_TRIANGLE_STRIP over the (nu+1) x (nv+1) grid, rows joined by degenerate triangles.
+struct SurfaceData {
+    static constexpr int kStride = 8;       // px py pz nx ny nz s t
+    std::vector<float> verts;
+    std::vector<unsigned> strip;
+    int nu=0, nv=0;
+};
+
+template<class F, class = void> struct HasAnalyticNormal : std::false_type {};
+template<class F> struct HasAnalyticNormal<F, std::void_t<decltype(std::declval<const F&>().normal(0.0f,0.0f,(float*)nullptr))>> : std::true_type {};
+
+template<class F>
+struct ParametricSurface {
+    F f;
+    float u0, u1, v0, v1;
+    bool flip = false;      // du x dv points to the back side: reverse winding and computed normals
+
+    void tessellate(int nu,int nv, SurfaceData& out) const
+    {
+        const int w = nv+1;
+        out.nu = nu; out.nv = nv;
+        out.verts.resize((size_t)SurfaceData::kStride*(nu+1)*w);
+        std::vector<float> soa(6*(size_t)w);
+        float *px=&soa[0], *py=px+w, *pz=py+w, *nx=pz+w, *ny=nx+w, *nz=ny+w;
+        const float du=(u1-u0)/nu, dv=(v1-v0)/nv, sgn = flip? -1.0f : 1.0f;
+
+        for(int i=0;i<=nu;i++){
+            const float u = u0 + du*i;
+            for(int j=0;j<w;j++){
+                const float v = v0 + dv*j;
+                SurfaceSample s; f(u,v,s);
+                px[j]=s.p[0]; py[j]=s.p[1]; pz[j]=s.p[2];
+                if constexpr (HasAnalyticNormal<F>::value){
+                    float n[3]; f.normal(u,v,n); nx[j]=n[0]; ny[j]=n[1]; nz[j]=n[2];
+                } else {
+                    nx[j]=sgn*(s.du[1]*s.dv[2]-s.du[2]*s.dv[1]);
+                    ny[j]=sgn*(s.du[2]*s.dv[0]-s.du[0]*s.dv[2]);
+                    nz[j]=sgn*(s.du[0]*s.dv[1]-s.du[1]*s.dv[0]);
+                }
+            }
+            for(int j=0;j<w;j++){
+                const float inv = 1.0f/std::sqrt(nx[j]*nx[j]+ny[j]*ny[j]+nz[j]*nz[j]+1e-30f);
+                nx[j]*=inv; ny[j]*=inv; nz[j]*=inv;
+            }
+            float* o = &out.verts[(size_t)SurfaceData::kStride*i*w];
+            const float s = (float)i/nu;
+            for(int j=0;j<w;j++,o+=SurfaceData::kStride){
+                o[0]=px[j]; o[1]=py[j]; o[2]=pz[j]; o[3]=nx[j]; o[4]=ny[j]; o[5]=nz[j];
+                o[6]=s; o[7]=(float)j/nv;
+            }
+        }
+
+        // Row i runs (i,j),(i+1,j) for j=0..nv, so its first triangle is wound around du x dv
+        // (flip swaps the pair). Each join repeats the last and the next first vertex: the
+        // count stays even, so every row starts with the same winding.
+        out.strip.clear(); out.strip.reserve((size_t)nu*(2*w+2));
+        const unsigned a = flip? 1 : 0, b = 1-a;
+        for(int i=0;i<nu;i++){
+            if(i>0){ out.strip.push_back(out.strip.back()); out.strip.push_back((unsigned)((i+a)*w)); }
+            for(int j=0;j<w;j++){
+                out.strip.push_back((unsigned)((i+a)*w+j));
+                out.strip.push_back((unsigned)((i+b)*w+j));
+            }
+        }
+    }
+};
+
+// Torus around the y axis: u along the ring, v around the tube. du x dv points into the tube.
+struct TorusFn {
+    float R, r;
+    void operator()(float u,float v, SurfaceSample& s) const {
+        const float cu=std::cos(u), su=std::sin(u), cv=std::cos(v), sv=std::sin(v), k=R+r*cv;
+        s.p[0]=k*cu;        s.p[1]=r*sv;  s.p[2]=k*su;
+        s.du[0]=-k*su;      s.du[1]=0;    s.du[2]=k*cu;
+        s.dv[0]=-r*sv*cu;   s.dv[1]=r*cv; s.dv[2]=-r*sv*su;
+    }
+    void normal(float u,float v, float n[3]) const {
+        const float cv=std::cos(v);
+        n[0]=std::cos(u)*cv; n[1]=std::sin(v); n[2]=std::sin(u)*cv;
+    }
+};
+
+template<class F>
+ParametricSurface<F> makeSurface(F f, float u0,float u1, float v0,float v1, bool flip=false)
+{ return ParametricSurface<F>{f,u0,u1,v0,v1,flip}; }
@@ -0,0 +1,62 @@
+#include "surface_cache.hpp"
+#include "util.hpp"
+#include "parametric.hpp"
+#include <memory>
+
+static std::vector<std::unique_ptr<SurfaceMesh>> gCache;   // few entries: linear lookup, stable addresses
+static int gBuilds = 0;
+
+// Helicoid: u radial, v angle; normal = ru x rv.
+struct HelicoidFn {
+    float c;
+    void operator()(float u,float v, SurfaceSample& s) const {
+        const float cv=std::cos(v), sv=std::sin(v);
+        s.p[0]=u*cv;   s.p[1]=u*sv;  s.p[2]=c*v;
+        s.du[0]=cv;    s.du[1]=sv;   s.du[2]=0;
+        s.dv[0]=-u*sv; s.dv[1]=u*cv; s.dv[2]=c;
+    }
+};
+
+static void upload(SurfaceMesh& m)
+{
+    glGenBuffers(1,&m.vbo); glBindBuffer(GL_ARRAY_BUFFER,m.vbo);
+    glBufferData(GL_ARRAY_BUFFER, m.data.verts.size()*sizeof(float), m.data.verts.data(), GL_STATIC_DRAW);
+    glGenBuffers(1,&m.ibo); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,m.ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m.data.strip.size()*sizeof(unsigned), m.data.strip.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER,0); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,0);
+}
+
+const SurfaceMesh& cachedSurface(const SurfaceKey& k)
+{
+    for(const auto& m : gCache) if (m->key==k) return *m;
+    auto m = std::make_unique<SurfaceMesh>(); m->key = k;
+    if (k.type==SurfaceType::Torus)
+        makeSurface(TorusFn{(float)k.a,(float)k.b}, 0,2*M_PI, 0,2*M_PI, true).tessellate(k.nu,k.nv,m->data);
+    else
+        makeSurface(HelicoidFn{(float)k.b}, 0,(float)k.a, 0,2*M_PI).tessellate(k.nu,k.nv,m->data);
+    upload(*m); ++gBuilds;
+    gCache.push_back(std::move(m));
+    return *gCache.back();
+}
+
+int surfaceCacheBuilds(){ return gBuilds; }
+
+void drawSurface(const SurfaceMesh& m)
+{
+    const GLsizei stride = SurfaceData::kStride*sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER,m.vbo); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,m.ibo);
+    glEnableClientState(GL_VERTEX_ARRAY); glEnableClientState(GL_NORMAL_ARRAY);
+    glVertexPointer(3,GL_FLOAT,stride,(const void*)0);
+    glNormalPointer(GL_FLOAT,stride,(const void*)(3*sizeof(float)));
+    glDrawElements(GL_TRIANGLE_STRIP,(GLsizei)m.data.strip.size(),GL_UNSIGNED_INT,(const void*)0);
+    glDisableClientState(GL_NORMAL_ARRAY); glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER,0); glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,0);
+}
+
+void drawSurfaceNormals(const SurfaceMesh& m, float s)
+{
+    for(size_t i=0;i<m.data.verts.size();i+=SurfaceData::kStride){
+        const float* p=&m.data.verts[i];
+        drawNormalLine(p[0],p[1],p[2],p[3],p[4],p[5],s);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "common.hpp"
+#include "parametric.hpp"
+
+// Tessellations keyed by surface type + parameters: built once by the parametric engine into
+// interleaved vertex data + one triangle strip, uploaded to GPU buffers, drawn from there.
+enum class SurfaceType { Torus, Helicoid };
+
+struct SurfaceKey {
+    SurfaceType type; double a, b; int nu, nv;   // Torus: a=R b=r, Helicoid: a=umax b=c
+    bool operator==(const SurfaceKey& o) const { return type==o.type && a==o.a && b==o.b && nu==o.nu && nv==o.nv; }
+};
+
+struct SurfaceMesh {
+    SurfaceKey key;
+    SurfaceData data;              // CPU copy, kept for debug normals
+    GLuint vbo=0, ibo=0;
+};
+
+// Returns the cached mesh for k, building and uploading it on first use only.
+const SurfaceMesh& cachedSurface(const SurfaceKey& k);
+int  surfaceCacheBuilds();         // number of tessellations built so far
+void drawSurface(const SurfaceMesh& m);
+void drawSurfaceNormals(const SurfaceMesh& m, float s=0.3f);
@@ -0,0 +1,51 @@
+#include "tessellation.hpp"
+
+int   gAdaptiveTess = 1;
+float gTessErrorPx  = 0.5f;
+
+static const int kMinSegs = 4, kMaxSegs = 256;
+
+double projectedPixelsPerUnit(const CameraState& cam, const double center[3], double radius)
+{
+    GLdouble mv[16]; GLint vp[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, mv);
+    glGetIntegerv(GL_VIEWPORT, vp);
+    // largest axis scale of the modelview, so scaled objects get finer too
+    double s2=0;
+    for(int c=0;c<3;c++) s2 = std::fmax(s2, mv[4*c]*mv[4*c]+mv[4*c+1]*mv[4*c+1]+mv[4*c+2]*mv[4*c+2]);
+    const double scale = std::sqrt(s2);
+    if (cam.mode==0) return scale*vp[3]/(2*cam.dim);
+
+    double e[3];
+    for(int i=0;i<3;i++) e[i] = mv[i]*center[0]+mv[4+i]*center[1]+mv[8+i]*center[2]+mv[12+i];
+    const double dist = std::fmax(std::sqrt(e[0]*e[0]+e[1]*e[1]+e[2]*e[2]) - radius*scale, 0.1);  // near plane
+    return scale*vp[3]/(2*dist*std::tan(rad(cam.fov)/2));
+}
+
+// Segments for an arc of curvature radius rho spanning angle theta: the chord sagitta
+// rho(1-cos(theta/2n)) ~ rho theta^2/(8n^2) must stay below tol pixels.
+static int arcSegments(double rho, double theta, double pxPerUnit)
+{
+    const double n = theta*std::sqrt(rho*pxPerUnit/(8.0*gTessErrorPx));
+    int p = kMinSegs;
+    while (p<kMaxSegs && p<n) p*=2;
+    return p;
+}
+
+TessLevel torusTessLevel(const CameraState& cam, double R, double r)
+{
+    const double c[3]={0,0,0};
+    const double ppu = projectedPixelsPerUnit(cam, c, R+r);
+    return { arcSegments(R+r, 2*M_PI, ppu), arcSegments(r, 2*M_PI, ppu) };
+}
+
+TessLevel helicoidTessLevel(const CameraState& cam, double umax, double c)
+{
+    // rulings along u are straight, only the normal turns (by atan(umax/c)); the rim helix
+    // at u=umax has curvature radius (umax^2+c^2)/umax
+    const double ctr[3]={0,0,M_PI*c};
+    const double ppu = projectedPixelsPerUnit(cam, ctr, std::sqrt(umax*umax+M_PI*M_PI*c*c));
+    const int nu = arcSegments(umax, std::atan2(umax,c), ppu);
+    const int nv = arcSegments((umax*umax+c*c)/umax, 2*M_PI, ppu);
+    return { nu, nv };
+}
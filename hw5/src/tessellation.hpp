@@ -0,0 +1,18 @@
+#pragma once
+#include "common.hpp"
+#include "camera.hpp"
+
+// Screen-space-error tessellation: segment counts are chosen so that the chord error of each
+// curved parameter direction stays under gTessErrorPx pixels for the current camera and the
+// current modelview. Counts are rounded up to powers of two, so the surface cache only ever
+// holds a handful of levels per surface and switching between them is a lookup.
+struct TessLevel { int nu, nv; };
+
+extern int   gAdaptiveTess;      // toggled by keyboard; 0 = fixed counts
+extern float gTessErrorPx;       // allowed chord error in pixels
+
+// Pixels per world unit at the point of a bounding sphere (object coords) nearest the eye.
+double projectedPixelsPerUnit(const CameraState& cam, const double center[3], double radius);
+
+TessLevel torusTessLevel(const CameraState& cam, double R, double r);
+TessLevel helicoidTessLevel(const CameraState& cam, double umax, double c);
@@ -1,11 +1,13 @@
 #include "util.hpp"
+#include "debug_draw.hpp"
+#include "gl_state.hpp"
 
 void hudPrintf(float x, float y, const char* fmt, ...)
 {
     char buf[1024];
     va_list args; va_start(args,fmt);
     vsnprintf(buf,sizeof(buf),fmt,args); va_end(args);
-    glDisable(GL_LIGHTING);
+    cachedDisable(GL_LIGHTING);
     glMatrixMode(GL_PROJECTION); glPushMatrix(); glLoadIdentity(); glOrtho(0,1,0,1,-1,1);
     glMatrixMode(GL_MODELVIEW); glPushMatrix(); glLoadIdentity();
     glColor3f(1,1,1);
@@ -15,7 +17,7 @@ void hudPrintf(float x, float y, const char* fmt, ...)
 }
 
 void drawNormalLine(float x,float y,float z,float nx,float ny,float nz,float s)
-{ glBegin(GL_LINES); glVertex3f(x,y,z); glVertex3f(x+nx*s,y+ny*s,z+nz*s); glEnd(); }
+{ debugLine(x,y,z, x+nx*s,y+ny*s,z+nz*s); }
 
 void normalFromTriangle(const float A[3], const float B[3], const float C[3])
 {
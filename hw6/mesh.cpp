@@ -7,74 +7,71 @@
 #endif
 
 #include "mesh.hpp"
+#include "parametric.hpp"
+#include <vector>
 #ifndef PI
 #define PI 3.14159265358979323846
 #endif
 
-void drawTorus(int M, int N, float R, float r)
-{
-    // param: u in [0,2pi) along major circle, v in [0,2pi) minor
-    for (int i=0;i<M;++i)
-    {
-        float u0 = (float)i/M*2*PI;
-        float u1 = (float)(i+1)/M*2*PI;
-        glBegin(GL_QUAD_STRIP);
-        for (int j=0;j<=N;++j)
-        {
-            float v = (float)j/N*2*PI;
-
-            float cu0=cos(u0), su0=sin(u0), cv=cos(v), sv=sin(v);
-            float cu1=cos(u1), su1=sin(u1);
+// Cone side: u around, v from base rim (0) to tip (1) (du x dv points inward).
+// Analytic normal, since du vanishes at the tip.
+struct ConeFn {
+    float radius, height;
+    void operator()(float u,float v, SurfaceSample& s) const {
+        float cu=std::cos(u), su=std::sin(u), k=(1-v)*radius;
+        s.p[0]=k*cu;           s.p[1]=v*height; s.p[2]=k*su;
+        s.du[0]=-k*su;         s.du[1]=0;       s.du[2]=k*cu;
+        s.dv[0]=-radius*cu;    s.dv[1]=height;  s.dv[2]=-radius*su;
+    }
+    void normal(float u,float, float n[3]) const {
+        float nx=std::cos(u)*height, ny=radius, nz=std::sin(u)*height;
+        float inv=1.0f/std::sqrt(nx*nx+ny*ny+nz*nz);
+        n[0]=nx*inv; n[1]=ny*inv; n[2]=nz*inv;
+    }
+};
 
-            // ring 0
-            float x0 = (R + r*cv)*cu0;
-            float y0 =  r*sv;
-            float z0 = (R + r*cv)*su0;
-            float nx0 = cv*cu0;
-            float ny0 = sv;
-            float nz0 = cv*su0;
-            glNormal3f(nx0, ny0, nz0);
-            glTexCoord2f((float)i/M, (float)j/N);
-            glVertex3f(x0,y0,z0);
+// tessellations are rebuilt only when a shape's parameters change
+struct CachedShape { int kind, n0, n1; float a, b; SurfaceData d; };
+static std::vector<CachedShape> shapeCache;
 
-            // ring 1
-            float x1 = (R + r*cv)*cu1;
-            float y1 =  r*sv;
-            float z1 = (R + r*cv)*su1;
-            float nx1 = cv*cu1;
-            float ny1 = sv;
-            float nz1 = cv*su1;
-            glNormal3f(nx1, ny1, nz1);
-            glTexCoord2f((float)(i+1)/M, (float)j/N);
-            glVertex3f(x1,y1,z1);
-        }
-        glEnd();
-    }
+template<class F>
+static const SurfaceData& cachedShape(int kind, int n0, int n1, float a, float b, const ParametricSurface<F>& surf)
+{
+    for (const auto& c : shapeCache)
+        if (c.kind==kind && c.n0==n0 && c.n1==n1 && c.a==a && c.b==b) return c.d;
+    shapeCache.push_back(CachedShape{kind,n0,n1,a,b,{}});
+    surf.tessellate(n0, n1, shapeCache.back().d);
+    return shapeCache.back().d;
 }
 
-void drawCone(int slices, float radius, float height)
+// interleaved p/n/uv arrays straight from client memory, one strip
+static void drawSurfaceData(const SurfaceData& d)
 {
-    // side
-    glBegin(GL_TRIANGLE_STRIP);
-    for(int i=0;i<=slices;++i){
-        float a = (float)i/slices * 2*PI;
-        float cx = cos(a), sz = sin(a);
-        // normal of cone side (approx): normalize(vec(radius*cx, height, radius*sz) x around)
-        float nx = cx*height;
-        float ny = radius;
-        float nz = sz*height;
-        float inv = 1.0f / std::sqrt(nx*nx+ny*ny+nz*nz);
-        nx*=inv; ny*=inv; nz*=inv;
+    const GLsizei stride = SurfaceData::kStride*sizeof(float);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer  (3, GL_FLOAT, stride, &d.verts[0]);
+    glNormalPointer  (   GL_FLOAT, stride, &d.verts[3]);
+    glTexCoordPointer(2, GL_FLOAT, stride, &d.verts[6]);
+    glDrawElements(GL_TRIANGLE_STRIP, (GLsizei)d.strip.size(), GL_UNSIGNED_INT, d.strip.data());
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
 
-        glNormal3f(nx,ny,nz);
-        glTexCoord2f((float)i/slices, 0.0f);
-        glVertex3f(radius*cx, 0.0f, radius*sz);
+void drawTorus(int M, int N, float R, float r)
+{
+    // u in [0,2pi] along major circle -> s, v in [0,2pi] minor -> t
+    drawSurfaceData(cachedShape(0, M, N, R, r,
+        makeSurface(TorusFn{R,r}, 0,2*PI, 0,2*PI, true)));
+}
 
-        glNormal3f(nx,ny,nz);
-        glTexCoord2f((float)i/slices, 1.0f);
-        glVertex3f(0.0f, height, 0.0f);
-    }
-    glEnd();
+void drawCone(int slices, float radius, float height)
+{
+    // side: s around, t from base (0) to tip (1)
+    drawSurfaceData(cachedShape(1, slices, 1, radius, height,
+        makeSurface(ConeFn{radius,height}, 0,2*PI, 0,1, true)));
 
     // base (circle)
     glNormal3f(0,-1,0);
@@ -0,0 +1,94 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "bench.h"
+#include "fastpow.h"
+#include "mesh.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define BENCH_N      512       /* superellipsoid grid */
+#define BENCH_REPS   20
+#define BENCH_POWS   (1<<22)
+
+static double seconds(void){ return (double)clock()/(double)CLOCKS_PER_SEC; }
+
+static float sgnf(float x){ return (float)((x>0)-(x<0)); }
+
+/* The superellipsoid loop as it was before the power tables: four powf per vertex. */
+static void superellipsoid_per_vertex(float* pos, int Nu,int Nv, float e1,float e2){
+  for(int j=0;j<Nv;j++){
+    float v = - (float)M_PI + (float)j/(Nv-1)*(2.0f*(float)M_PI);
+    float sv = sinf(v), cv = cosf(v);
+    for(int i=0;i<Nu;i++){
+      float u = - (float)M_PI/2.0f + (float)i/(Nu-1)*(float)M_PI;
+      float su = sinf(u), cu = cosf(u);
+      float cu_e1 = powf(fabsf(cu),e1), su_e1 = powf(fabsf(su),e1);
+      float cv_e2 = powf(fabsf(cv),e2), sv_e2 = powf(fabsf(sv),e2);
+      float* p=&pos[3*(j*Nu+i)];
+      p[0] = sgnf(cu)*cu_e1 * sgnf(cv)*cv_e2;
+      p[1] = sgnf(cu)*cu_e1 * sgnf(sv)*sv_e2;
+      p[2] = sgnf(su)*su_e1;
+    }
+  }
+}
+
+static void bench_pow_kernel(void){
+  float* x=(float*)malloc((size_t)BENCH_POWS*sizeof(float));
+  float* y=(float*)malloc((size_t)BENCH_POWS*sizeof(float));
+  if(!x||!y){ fprintf(stderr,"OOM bench\n"); exit(1); }
+  for(int i=0;i<BENCH_POWS;i++) x[i]=(float)(i+1)/(float)BENCH_POWS;
+
+  printf("pow kernel, %d values of |x|^0.4:\n", BENCH_POWS);
+  for(int impl=POW_LIBM; impl<=POW_FAST; impl++){
+    pow_set_impl((PowImpl)impl);
+    double t0=seconds();
+    pow_abs_array(y,x,0.4f,BENCH_POWS);
+    double dt=seconds()-t0;
+    printf("  %-16s %8.1f Mpow/s\n", pow_impl_name((PowImpl)impl), BENCH_POWS/dt*1e-6);
+  }
+  double worst=0.0;
+  for(int i=0;i<BENCH_POWS;i++){
+    double r=pow((double)x[i],0.4), err=fabs(y[i]-r)/r;
+    if(err>worst) worst=err;
+  }
+  printf("  max relative error vs double pow: %.2g\n", worst);
+  free(x); free(y);
+}
+
+static void bench_superellipsoid(void){
+  Mesh m=mesh_make_superellipsoid(BENCH_N,BENCH_N, 1.0f,1.0f,1.0f, 0.4f,0.4f);
+  float* scratch=(float*)malloc((size_t)mesh_superellipsoid_scratch_floats(BENCH_N,BENCH_N)*sizeof(float));
+  if(!scratch){ fprintf(stderr,"OOM bench\n"); exit(1); }
+  double verts=(double)m.n_verts*BENCH_REPS;
+
+  printf("superellipsoid %dx%d, positions + normals:\n", BENCH_N, BENCH_N);
+  double t0=seconds();
+  for(int r=0;r<BENCH_REPS;r++){
+    superellipsoid_per_vertex(m.pos, BENCH_N,BENCH_N, 0.4f+0.01f*r, 0.4f);
+    mesh_compute_normals(&m);
+  }
+  printf("  %-30s %8.1f Mvert/s\n", "per-vertex powf (old)", verts/(seconds()-t0)*1e-6);
+  for(int impl=POW_LIBM; impl<=POW_FAST; impl++){
+    pow_set_impl((PowImpl)impl);
+    t0=seconds();
+    for(int r=0;r<BENCH_REPS;r++)
+      mesh_update_superellipsoid(&m, BENCH_N,BENCH_N, 1.0f,1.0f,1.0f, 0.4f+0.01f*r, 0.4f, scratch);
+    printf("  power tables, %-16s %8.1f Mvert/s\n", pow_impl_name((PowImpl)impl), verts/(seconds()-t0)*1e-6);
+  }
+  free(scratch);
+  mesh_free(&m);
+}
+
+int run_benchmarks(void){
+  PowImpl saved=pow_get_impl();
+  bench_pow_kernel();
+  bench_superellipsoid();
+  pow_set_impl(saved);
+  return 0;
+}
@@ -0,0 +1,7 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Headless timings of the mesh generators (./scene --bench); returns the process exit code. */
+int run_benchmarks(void);
+
+#endif
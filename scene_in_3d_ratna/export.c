@@ -0,0 +1,325 @@
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "export.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Staging size for interleaved / transformed / byte-swapped output. */
+#define EXPORT_CHUNK (1<<16)
+
+
+/* ---- chunked writer ---- */
+
+typedef struct {
+  FILE* f;
+  unsigned char buf[EXPORT_CHUNK];
+  size_t n;
+  int failed;
+} Writer;
+
+static int host_is_little_endian(void){
+  const uint16_t one=1;
+  unsigned char b; memcpy(&b,&one,1);
+  return b==1;
+}
+
+static void w_flush(Writer* W){
+  if(W->n && !W->failed && fwrite(W->buf,1,W->n,W->f)!=W->n) W->failed=1;
+  W->n=0;
+}
+
+static void w_bytes(Writer* W, const void* p, size_t n){
+  const unsigned char* s=(const unsigned char*)p;
+  while(n){
+    size_t k=EXPORT_CHUNK-W->n;
+    if(k>n) k=n;
+    memcpy(W->buf+W->n,s,k);
+    W->n+=k; s+=k; n-=k;
+    if(W->n==EXPORT_CHUNK) w_flush(W);
+  }
+}
+
+static void w_u8(Writer* W, unsigned char v){ w_bytes(W,&v,1); }
+
+static void w_u32(Writer* W, uint32_t v){
+  unsigned char b[4]={ (unsigned char)v, (unsigned char)(v>>8), (unsigned char)(v>>16), (unsigned char)(v>>24) };
+  w_bytes(W,b,4);
+}
+
+static void w_f32(Writer* W, float v){
+  uint32_t u; memcpy(&u,&v,4);
+  w_u32(W,u);
+}
+
+/* Large 32-bit arrays: straight from the caller's memory on little-endian hosts, otherwise
+   swapped through the staging buffer. */
+static void w_array32(Writer* W, const void* p, size_t count){
+  if(host_is_little_endian()){
+    w_flush(W);
+    const unsigned char* s=(const unsigned char*)p;
+    size_t left=4*count;
+    while(left && !W->failed){
+      size_t k = left>EXPORT_CHUNK ? EXPORT_CHUNK : left;
+      if(fwrite(s,1,k,W->f)!=k) W->failed=1;
+      s+=k; left-=k;
+    }
+  }else{
+    const uint32_t* u=(const uint32_t*)p;
+    for(size_t i=0;i<count;i++) w_u32(W,u[i]);
+  }
+}
+
+static void w_pad(Writer* W, size_t n, unsigned char c){ while(n--) w_u8(W,c); }
+
+static int w_open(Writer* W, const char* path){
+  memset(W,0,sizeof(*W));
+  W->f=fopen(path,"wb");
+  if(!W->f){ fprintf(stderr,"export: cannot open %s\n",path); return -1; }
+  return 0;
+}
+
+static int w_close(Writer* W, const char* path){
+  w_flush(W);
+  if(fclose(W->f)!=0) W->failed=1;
+  if(W->failed){ fprintf(stderr,"export: write to %s failed\n",path); return -1; }
+  return 0;
+}
+
+
+/* ---- JSON text (small: a few hundred bytes per instance) ---- */
+
+typedef struct { char* s; size_t n, cap; } Text;
+
+static void text_printf(Text* T, const char* fmt, ...){
+  for(;;){
+    va_list ap;
+    va_start(ap,fmt);
+    int k=vsnprintf(T->s ? T->s+T->n : NULL, T->s ? T->cap-T->n : 0, fmt, ap);
+    va_end(ap);
+    if(k<0){ fprintf(stderr,"export: format error\n"); exit(1); }
+    if(T->s && T->n+(size_t)k < T->cap){ T->n+=(size_t)k; return; }
+    T->cap = (T->cap ? 2*T->cap : 4096) + (size_t)k;
+    T->s=(char*)realloc(T->s,T->cap);
+    if(!T->s){ fprintf(stderr,"OOM export\n"); exit(1); }
+  }
+}
+
+
+/* ---- transforms ---- */
+
+/* q = qz * qy * qx, matching glRotatef(rz,0,0,1); glRotatef(ry,0,1,0); glRotatef(rx,1,0,0). */
+static void instance_quat(const float r_deg[3], float q[4]){
+  float hx=0.5f*r_deg[0]*(float)M_PI/180.0f, hy=0.5f*r_deg[1]*(float)M_PI/180.0f, hz=0.5f*r_deg[2]*(float)M_PI/180.0f;
+  float cx=cosf(hx), sx=sinf(hx), cy=cosf(hy), sy=sinf(hy), cz=cosf(hz), sz=sinf(hz);
+  q[0]= cz*cy*sx - sz*sy*cx;     /* x */
+  q[1]= cz*sy*cx + sz*cy*sx;     /* y */
+  q[2]= sz*cy*cx - cz*sy*sx;     /* z */
+  q[3]= cz*cy*cx + sz*sy*sx;     /* w */
+}
+
+/* Row-major 3x3 of R*S, used to bake PLY positions; normals use R*S^-1. */
+static void instance_basis(const ExportInstance* I, float M[9], float N[9]){
+  float q[4]; instance_quat(I->r_deg,q);
+  float x=q[0], y=q[1], z=q[2], w=q[3];
+  float R[9]={
+    1-2*(y*y+z*z), 2*(x*y-z*w),   2*(x*z+y*w),
+    2*(x*y+z*w),   1-2*(x*x+z*z), 2*(y*z-x*w),
+    2*(x*z-y*w),   2*(y*z+x*w),   1-2*(x*x+y*y)
+  };
+  for(int r=0;r<3;r++)
+    for(int c=0;c<3;c++){
+      M[3*r+c]=R[3*r+c]*I->s[c];
+      N[3*r+c]=R[3*r+c]/(I->s[c]!=0.0f ? I->s[c] : 1.0f);
+    }
+}
+
+static void mat3_apply(const float M[9], const float* v, float out[3]){
+  out[0]=M[0]*v[0]+M[1]*v[1]+M[2]*v[2];
+  out[1]=M[3]*v[0]+M[4]*v[1]+M[5]*v[2];
+  out[2]=M[6]*v[0]+M[7]*v[1]+M[8]*v[2];
+}
+
+static unsigned char color_byte(float c){
+  if(c<0.0f) c=0.0f;
+  if(c>1.0f) c=1.0f;
+  return (unsigned char)(c*255.0f+0.5f);
+}
+
+
+/* ---- glTF ---- */
+
+int export_glb(const char* path, const ExportInstance* inst, int n_inst){
+  /* distinct meshes, in first-use order */
+  const Mesh** uniq=(const Mesh**)malloc((size_t)(n_inst>0?n_inst:1)*sizeof(*uniq));
+  int* inst_mesh=(int*)malloc((size_t)(n_inst>0?n_inst:1)*sizeof(int));
+  if(!uniq||!inst_mesh){ fprintf(stderr,"OOM export\n"); exit(1); }
+  int n_uniq=0;
+  for(int i=0;i<n_inst;i++){
+    int k=0;
+    while(k<n_uniq && uniq[k]!=inst[i].mesh) k++;
+    if(k==n_uniq) uniq[n_uniq++]=inst[i].mesh;
+    inst_mesh[i]=k;
+  }
+
+  /* per mesh: positions, normals, indices -- all 4-byte aligned already */
+  uint64_t bin_len=0;
+  for(int k=0;k<n_uniq;k++) bin_len += 24ull*(uint64_t)uniq[k]->n_verts + 12ull*(uint64_t)uniq[k]->n_tris;
+
+  Text J={0};
+  text_printf(&J,"{\"asset\":{\"version\":\"2.0\",\"generator\":\"scene_in_3d_ratna\"},\"scene\":0,");
+  text_printf(&J,"\"scenes\":[{\"nodes\":[");
+  for(int i=0;i<n_inst;i++) text_printf(&J,"%s%d", i?",":"", i);
+  text_printf(&J,"]}],\"nodes\":[");
+  for(int i=0;i<n_inst;i++){
+    const ExportInstance* I=&inst[i];
+    float q[4]; instance_quat(I->r_deg,q);
+    text_printf(&J,"%s{\"mesh\":%d,\"translation\":[%.9g,%.9g,%.9g],\"rotation\":[%.9g,%.9g,%.9g,%.9g],\"scale\":[%.9g,%.9g,%.9g]}",
+                i?",":"", i, I->t[0],I->t[1],I->t[2], q[0],q[1],q[2],q[3], I->s[0],I->s[1],I->s[2]);
+  }
+  text_printf(&J,"],\"meshes\":[");
+  for(int i=0;i<n_inst;i++){
+    int k=inst_mesh[i];
+    text_printf(&J,"%s{\"primitives\":[{\"attributes\":{\"POSITION\":%d,\"NORMAL\":%d},\"indices\":%d,\"material\":%d}]}",
+                i?",":"", 3*k, 3*k+1, 3*k+2, i);
+  }
+  text_printf(&J,"],\"materials\":[");
+  for(int i=0;i<n_inst;i++){
+    const float* c=inst[i].color;
+    text_printf(&J,"%s{\"pbrMetallicRoughness\":{\"baseColorFactor\":[%.6g,%.6g,%.6g,1],\"metallicFactor\":0,\"roughnessFactor\":0.8}}",
+                i?",":"", c[0],c[1],c[2]);
+  }
+  text_printf(&J,"],\"accessors\":[");
+  for(int k=0;k<n_uniq;k++){
+    const Mesh* m=uniq[k];
+    float lo[3]={0,0,0}, hi[3]={0,0,0};
+    for(int v=0;v<m->n_verts;v++)
+      for(int a=0;a<3;a++){
+        float x=m->pos[3*v+a];
+        if(v==0||x<lo[a]) lo[a]=x;
+        if(v==0||x>hi[a]) hi[a]=x;
+      }
+    text_printf(&J,"%s{\"bufferView\":%d,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\",\"min\":[%.9g,%.9g,%.9g],\"max\":[%.9g,%.9g,%.9g]}",
+                k?",":"", 3*k, m->n_verts, lo[0],lo[1],lo[2], hi[0],hi[1],hi[2]);
+    text_printf(&J,",{\"bufferView\":%d,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\"}", 3*k+1, m->n_verts);
+    text_printf(&J,",{\"bufferView\":%d,\"componentType\":5125,\"count\":%d,\"type\":\"SCALAR\"}", 3*k+2, 3*m->n_tris);
+  }
+  text_printf(&J,"],\"bufferViews\":[");
+  uint64_t off=0;
+  for(int k=0;k<n_uniq;k++){
+    uint64_t vb=12ull*(uint64_t)uniq[k]->n_verts, ib=12ull*(uint64_t)uniq[k]->n_tris;
+    text_printf(&J,"%s{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu,\"target\":34962}",
+                k?",":"", (unsigned long long)off, (unsigned long long)vb); off+=vb;
+    text_printf(&J,",{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu,\"target\":34962}",
+                (unsigned long long)off, (unsigned long long)vb); off+=vb;
+    text_printf(&J,",{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu,\"target\":34963}",
+                (unsigned long long)off, (unsigned long long)ib); off+=ib;
+  }
+  text_printf(&J,"],\"buffers\":[{\"byteLength\":%llu}]}", (unsigned long long)bin_len);
+
+  size_t json_pad=(4-J.n%4)%4;
+  uint64_t total=12 + 8+J.n+json_pad + 8+bin_len;
+  if(total>0xffffffffull){
+    fprintf(stderr,"export: %s would be %llu bytes, over the .glb limit\n",path,(unsigned long long)total);
+    free(J.s); free(uniq); free(inst_mesh);
+    return -1;
+  }
+
+  Writer* W=(Writer*)malloc(sizeof(Writer));
+  if(!W){ fprintf(stderr,"OOM export\n"); exit(1); }
+  int rc=-1;
+  if(w_open(W,path)==0){
+    w_bytes(W,"glTF",4); w_u32(W,2); w_u32(W,(uint32_t)total);
+    w_u32(W,(uint32_t)(J.n+json_pad)); w_bytes(W,"JSON",4);
+    w_bytes(W,J.s,J.n); w_pad(W,json_pad,' ');
+    w_u32(W,(uint32_t)bin_len); w_bytes(W,"BIN\0",4);
+    for(int k=0;k<n_uniq && !W->failed;k++){
+      w_array32(W,uniq[k]->pos,3*(size_t)uniq[k]->n_verts);
+      w_array32(W,uniq[k]->nor,3*(size_t)uniq[k]->n_verts);
+      w_array32(W,uniq[k]->idx,3*(size_t)uniq[k]->n_tris);
+    }
+    rc=w_close(W,path);
+  }
+  free(W); free(J.s); free(uniq); free(inst_mesh);
+  return rc;
+}
+
+
+/* ---- PLY ---- */
+
+int export_ply(const char* path, const ExportInstance* inst, int n_inst){
+  uint64_t nv=0, nt=0;
+  for(int i=0;i<n_inst;i++){ nv+=(uint64_t)inst[i].mesh->n_verts; nt+=(uint64_t)inst[i].mesh->n_tris; }
+  if(nv>0xffffffffull){ fprintf(stderr,"export: %s has too many vertices for 32-bit indices\n",path); return -1; }
+
+  Writer* W=(Writer*)malloc(sizeof(Writer));
+  if(!W){ fprintf(stderr,"OOM export\n"); exit(1); }
+  if(w_open(W,path)!=0){ free(W); return -1; }
+
+  char header[512];
+  int hn=snprintf(header,sizeof(header),
+    "ply\nformat binary_little_endian 1.0\ncomment generated by scene_in_3d_ratna\n"
+    "element vertex %llu\nproperty float x\nproperty float y\nproperty float z\n"
+    "property float nx\nproperty float ny\nproperty float nz\n"
+    "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+    "element face %llu\nproperty list uchar uint vertex_indices\nend_header\n",
+    (unsigned long long)nv, (unsigned long long)nt);
+  w_bytes(W,header,(size_t)hn);
+
+  for(int i=0;i<n_inst && !W->failed;i++){
+    const ExportInstance* I=&inst[i];
+    const Mesh* m=I->mesh;
+    float M[9], N[9];
+    instance_basis(I,M,N);
+    unsigned char rgb[3]={ color_byte(I->color[0]), color_byte(I->color[1]), color_byte(I->color[2]) };
+    for(int v=0;v<m->n_verts;v++){
+      float p[3], n[3];
+      mat3_apply(M,&m->pos[3*v],p);
+      mat3_apply(N,&m->nor[3*v],n);
+      float L=sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+      if(L>1e-20f){ n[0]/=L; n[1]/=L; n[2]/=L; }
+      w_f32(W,p[0]+I->t[0]); w_f32(W,p[1]+I->t[1]); w_f32(W,p[2]+I->t[2]);
+      w_f32(W,n[0]); w_f32(W,n[1]); w_f32(W,n[2]);
+      w_bytes(W,rgb,3);
+    }
+  }
+  uint32_t base=0;
+  for(int i=0;i<n_inst && !W->failed;i++){
+    const Mesh* m=inst[i].mesh;
+    for(int t=0;t<m->n_tris;t++){
+      w_u8(W,3);
+      w_u32(W,base+m->idx[3*t]); w_u32(W,base+m->idx[3*t+1]); w_u32(W,base+m->idx[3*t+2]);
+    }
+    base+=(uint32_t)m->n_verts;
+  }
+  int rc=w_close(W,path);
+  free(W);
+  return rc;
+}
+
+
+static ExportInstance identity_instance(const Mesh* m){
+  ExportInstance I;
+  memset(&I,0,sizeof(I));
+  I.mesh=m;
+  I.s[0]=I.s[1]=I.s[2]=1.0f;
+  I.color[0]=I.color[1]=I.color[2]=0.8f;
+  return I;
+}
+
+int mesh_write_glb(const char* path, const Mesh* m){
+  ExportInstance I=identity_instance(m);
+  return export_glb(path,&I,1);
+}
+
+int mesh_write_ply(const char* path, const Mesh* m){
+  ExportInstance I=identity_instance(m);
+  return export_ply(path,&I,1);
+}
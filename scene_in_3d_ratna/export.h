@@ -0,0 +1,31 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "mesh.h"
+
+/* One placed copy of a mesh, with the same transform order as draw_mesh_instanced:
+   translate, rotate about z, y, x (degrees), then scale. */
+typedef struct {
+  const Mesh* mesh;
+  float t[3];
+  float r_deg[3];
+  float s[3];
+  float color[3];
+} ExportInstance;
+
+/* Binary glTF 2.0 (.glb): every distinct Mesh becomes one set of position/normal/index
+   accessors and every instance a node (plus a mesh entry carrying its colour), so shared meshes
+   are stored once. Vertex and index arrays are written straight from the Mesh in fixed-size
+   chunks; nothing proportional to the mesh size is allocated. Returns 0, or -1 after printing
+   why (I/O error, or more than the 4 GiB a .glb can address). */
+int export_glb(const char* path, const ExportInstance* inst, int n_inst);
+
+/* Binary little-endian PLY with the instances baked into one triangle mesh (world-space
+   positions and normals, per-vertex colour), streamed through the same chunked writer. */
+int export_ply(const char* path, const ExportInstance* inst, int n_inst);
+
+/* Single mesh, identity transform. */
+int mesh_write_glb(const char* path, const Mesh* m);
+int mesh_write_ply(const char* path, const Mesh* m);
+
+#endif
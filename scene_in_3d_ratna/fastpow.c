@@ -0,0 +1,135 @@
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include "fastpow.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define FASTPOW_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define FASTPOW_NEON 1
+#endif
+
+/* log2(m), m in [sqrt(1/2), sqrt(2)): atanh series in t = (m-1)/(m+1), |t| <= 0.1716,
+   truncated after t^7 (next term < 5e-8). exp2(f), f in [-1/2, 1/2]: degree-6 Taylor
+   (remainder < 1.2e-7). */
+#define L1 2.8853900817779268f
+#define L3 0.9617966939259756f
+#define L5 0.5770780163555854f
+#define L7 0.4121985831111325f
+#define E1 0.6931471805599453f
+#define E2 0.2402265069591007f
+#define E3 0.0555041086648216f
+#define E4 0.0096181291076285f
+#define E5 0.0013333558146428f
+#define E6 0.0001540353039338f
+#define SQRT2 1.41421356f
+#define EXP_LIMIT 126.0f
+
+static PowImpl gImpl = POW_FAST;
+
+void    pow_set_impl(PowImpl impl){ gImpl = impl; }
+PowImpl pow_get_impl(void){ return gImpl; }
+const char* pow_impl_name(PowImpl impl){ return impl==POW_FAST ? "fast exp2/log2" : "libm powf"; }
+
+
+float fast_pow_abs(float x, float e){
+  x=fabsf(x);
+  if(x<FLT_MIN) return 0.0f;
+  unsigned int bits; memcpy(&bits,&x,4);
+  float k=(float)((int)(bits>>23)-127);
+  bits=(bits&0x7fffffu)|0x3f800000u;
+  float m; memcpy(&m,&bits,4);
+  if(m>SQRT2){ m*=0.5f; k+=1.0f; }
+  float t=(m-1.0f)/(m+1.0f), t2=t*t;
+  float y=e*(k + t*(L1 + t2*(L3 + t2*(L5 + t2*L7))));
+  if(y<-EXP_LIMIT) y=-EXP_LIMIT;
+  if(y> EXP_LIMIT) y= EXP_LIMIT;
+  float n=(float)(int)(y+EXP_LIMIT+1.5f)-(EXP_LIMIT+1.0f), f=y-n;   /* round; the sum is positive */
+  float p=1.0f + f*(E1 + f*(E2 + f*(E3 + f*(E4 + f*(E5 + f*E6)))));
+  unsigned int sb=(unsigned int)((int)n+127)<<23;
+  float s; memcpy(&s,&sb,4);
+  return p*s;
+}
+
+
+#if FASTPOW_SSE2
+static __m128 pow_abs4(__m128 x, __m128 e){
+  const __m128 one=_mm_set1_ps(1.0f);
+  x=_mm_and_ps(x,_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+  __m128 tiny=_mm_cmplt_ps(x,_mm_set1_ps(FLT_MIN));
+  __m128i bits=_mm_castps_si128(x);
+  __m128 k=_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits,23),_mm_set1_epi32(127)));
+  __m128 m=_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits,_mm_set1_epi32(0x7fffff)),_mm_set1_epi32(0x3f800000)));
+  __m128 big=_mm_cmpgt_ps(m,_mm_set1_ps(SQRT2));
+  m=_mm_or_ps(_mm_and_ps(big,_mm_mul_ps(m,_mm_set1_ps(0.5f))),_mm_andnot_ps(big,m));
+  k=_mm_add_ps(k,_mm_and_ps(big,one));
+  __m128 t=_mm_div_ps(_mm_sub_ps(m,one),_mm_add_ps(m,one)), t2=_mm_mul_ps(t,t);
+  __m128 l=_mm_add_ps(_mm_set1_ps(L5),_mm_mul_ps(t2,_mm_set1_ps(L7)));
+  l=_mm_add_ps(_mm_set1_ps(L3),_mm_mul_ps(t2,l));
+  l=_mm_add_ps(_mm_set1_ps(L1),_mm_mul_ps(t2,l));
+  __m128 y=_mm_mul_ps(e,_mm_add_ps(k,_mm_mul_ps(t,l)));
+  y=_mm_min_ps(_mm_max_ps(y,_mm_set1_ps(-EXP_LIMIT)),_mm_set1_ps(EXP_LIMIT));
+  __m128i n=_mm_cvtps_epi32(y);                      /* round to nearest */
+  __m128 f=_mm_sub_ps(y,_mm_cvtepi32_ps(n));
+  __m128 p=_mm_add_ps(_mm_set1_ps(E5),_mm_mul_ps(f,_mm_set1_ps(E6)));
+  p=_mm_add_ps(_mm_set1_ps(E4),_mm_mul_ps(f,p));
+  p=_mm_add_ps(_mm_set1_ps(E3),_mm_mul_ps(f,p));
+  p=_mm_add_ps(_mm_set1_ps(E2),_mm_mul_ps(f,p));
+  p=_mm_add_ps(_mm_set1_ps(E1),_mm_mul_ps(f,p));
+  p=_mm_add_ps(one,_mm_mul_ps(f,p));
+  __m128 s=_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n,_mm_set1_epi32(127)),23));
+  return _mm_andnot_ps(tiny,_mm_mul_ps(p,s));
+}
+#define POW4_LOAD(p)     _mm_loadu_ps(p)
+#define POW4_STORE(p,v)  _mm_storeu_ps(p,v)
+#define POW4_SPLAT(v)    _mm_set1_ps(v)
+#define POW4_LANES 4
+#elif FASTPOW_NEON
+static float32x4_t pow_abs4(float32x4_t x, float32x4_t e){
+  const float32x4_t one=vdupq_n_f32(1.0f);
+  x=vabsq_f32(x);
+  uint32x4_t tiny=vcltq_f32(x,vdupq_n_f32(FLT_MIN));
+  uint32x4_t bits=vreinterpretq_u32_f32(x);
+  float32x4_t k=vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits,23)),vdupq_n_s32(127)));
+  float32x4_t m=vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits,vdupq_n_u32(0x7fffff)),vdupq_n_u32(0x3f800000)));
+  uint32x4_t big=vcgtq_f32(m,vdupq_n_f32(SQRT2));
+  m=vbslq_f32(big,vmulq_n_f32(m,0.5f),m);
+  k=vaddq_f32(k,vbslq_f32(big,one,vdupq_n_f32(0.0f)));
+  float32x4_t t=vdivq_f32(vsubq_f32(m,one),vaddq_f32(m,one)), t2=vmulq_f32(t,t);
+  float32x4_t l=vmlaq_f32(vdupq_n_f32(L5),t2,vdupq_n_f32(L7));
+  l=vmlaq_f32(vdupq_n_f32(L3),t2,l);
+  l=vmlaq_f32(vdupq_n_f32(L1),t2,l);
+  float32x4_t y=vmulq_f32(e,vmlaq_f32(k,t,l));
+  y=vminq_f32(vmaxq_f32(y,vdupq_n_f32(-EXP_LIMIT)),vdupq_n_f32(EXP_LIMIT));
+  int32x4_t n=vcvtnq_s32_f32(y);
+  float32x4_t f=vsubq_f32(y,vcvtq_f32_s32(n));
+  float32x4_t p=vmlaq_f32(vdupq_n_f32(E5),f,vdupq_n_f32(E6));
+  p=vmlaq_f32(vdupq_n_f32(E4),f,p);
+  p=vmlaq_f32(vdupq_n_f32(E3),f,p);
+  p=vmlaq_f32(vdupq_n_f32(E2),f,p);
+  p=vmlaq_f32(vdupq_n_f32(E1),f,p);
+  p=vmlaq_f32(one,f,p);
+  float32x4_t s=vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n,vdupq_n_s32(127)),23));
+  return vbslq_f32(tiny,vdupq_n_f32(0.0f),vmulq_f32(p,s));
+}
+#define POW4_LOAD(p)     vld1q_f32(p)
+#define POW4_STORE(p,v)  vst1q_f32(p,v)
+#define POW4_SPLAT(v)    vdupq_n_f32(v)
+#define POW4_LANES 4
+#endif
+
+void pow_abs_array(float* out, const float* x, float e, int n){
+  int i=0;
+  if(gImpl==POW_LIBM){
+    for(;i<n;i++) out[i]=powf(fabsf(x[i]),e);
+    return;
+  }
+#ifdef POW4_LANES
+  for(;i+POW4_LANES<=n;i+=POW4_LANES) POW4_STORE(&out[i],pow_abs4(POW4_LOAD(&x[i]),POW4_SPLAT(e)));
+#endif
+  for(;i<n;i++) out[i]=fast_pow_abs(x[i],e);
+}
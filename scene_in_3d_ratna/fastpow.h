@@ -0,0 +1,22 @@
+#ifndef FASTPOW_H
+#define FASTPOW_H
+
+/* |x|^e for e > 0 as exp2(e * log2|x|) with short polynomials, 4 lanes at a time on SSE2 or
+   NEON. Inputs below FLT_MIN give 0, results are clamped to [2^-126, 2^126].
+   Max relative error is 1.2e-6 + 1.1e-7 * |e * log2|x|| (checked against double pow for
+   e in [0.05, 8], |x| in [2^-60, 1]), so under 3.5e-6 whenever the result is above 1e-6. */
+
+typedef enum { POW_LIBM = 0, POW_FAST = 1 } PowImpl;
+
+void    pow_set_impl(PowImpl impl);
+PowImpl pow_get_impl(void);
+const char* pow_impl_name(PowImpl impl);
+
+/* out[i] = |x[i]|^e with the selected implementation; out may alias x. */
+void    pow_abs_array(float* out, const float* x, float e, int n);
+
+/* Scalar form of the approximation regardless of the selection. Per call it does not beat a
+   table-driven libm powf; the win comes from batching through pow_abs_array. */
+float   fast_pow_abs(float x, float e);
+
+#endif
@@ -0,0 +1,129 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "halfedge.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+HalfEdgeMesh halfedge_build(const Mesh* m){
+  HalfEdgeMesh H;
+  H.n_verts = m->n_verts;
+  H.n_half  = 3*m->n_tris;
+  H.twin    = (int*)malloc((size_t)(H.n_half>0?H.n_half:1)*sizeof(int));
+  H.vert_he = (int*)malloc((size_t)(H.n_verts>0?H.n_verts:1)*sizeof(int));
+  int* off  = (int*)calloc((size_t)H.n_verts+1,sizeof(int));
+  int* out  = (int*)malloc((size_t)(H.n_half>0?H.n_half:1)*sizeof(int));
+  if(!H.twin||!H.vert_he||!off||!out){ fprintf(stderr,"OOM halfedge\n"); exit(1); }
+
+  /* bucket outgoing half-edges by origin (counting sort) */
+  for(int h=0;h<H.n_half;h++) off[m->idx[h]+1]++;
+  for(int v=0;v<H.n_verts;v++) off[v+1]+=off[v];
+  for(int v=0;v<H.n_verts;v++) H.vert_he[v]=off[v];      /* reused as fill cursor */
+  for(int h=0;h<H.n_half;h++) out[H.vert_he[m->idx[h]]++]=h;
+
+  for(int h=0;h<H.n_half;h++) H.twin[h]=-1;
+  for(int h=0;h<H.n_half;h++){
+    if(H.twin[h]>=0) continue;
+    unsigned int a=he_origin(m,h), b=he_dest(m,h);
+    for(int j=off[b];j<off[b+1];j++){
+      int g=out[j];
+      if(H.twin[g]<0 && he_dest(m,g)==a){ H.twin[h]=g; H.twin[g]=h; break; }
+    }
+  }
+
+  for(int v=0;v<H.n_verts;v++) H.vert_he[v]=-1;
+  for(int h=0;h<H.n_half;h++){
+    unsigned int v=he_origin(m,h);
+    if(H.vert_he[v]<0 || H.twin[h]<0) H.vert_he[v]=h;
+  }
+  free(off); free(out);
+  return H;
+}
+
+void halfedge_free(HalfEdgeMesh* H){
+  if(!H) return;
+  free(H->twin); free(H->vert_he);
+  memset(H,0,sizeof(*H));
+}
+
+int halfedge_is_boundary_vertex(const HalfEdgeMesh* H, int v){
+  int h=H->vert_he[v];
+  return h>=0 && H->twin[h]<0;
+}
+
+int halfedge_vertex_ring(const HalfEdgeMesh* H, const Mesh* m, int v, unsigned int* out, int max_out){
+  int start=H->vert_he[v];
+  if(start<0) return 0;
+  int n=0, h=start;
+  do{
+    if(n<max_out) out[n]=he_dest(m,h);
+    n++;
+    int p=he_prev(h);
+    if(H->twin[p]<0){
+      /* fan ends on a boundary: the incoming edge's origin closes the ring */
+      if(n<max_out) out[n]=he_origin(m,p);
+      n++;
+      break;
+    }
+    h=H->twin[p];
+  }while(h!=start && n<=H->n_half);
+  return n;
+}
+
+int halfedge_mark_creases(const HalfEdgeMesh* H, const Mesh* m, float angle_deg, unsigned char* crease){
+  float cos_max=cosf(angle_deg*(float)M_PI/180.0f);
+  float* fn=(float*)malloc(3*(size_t)(m->n_tris>0?m->n_tris:1)*sizeof(float));
+  if(!fn){ fprintf(stderr,"OOM halfedge\n"); exit(1); }
+  for(int t=0;t<m->n_tris;t++){
+    const float* a=&m->pos[3*m->idx[3*t]];
+    const float* b=&m->pos[3*m->idx[3*t+1]];
+    const float* c=&m->pos[3*m->idx[3*t+2]];
+    float u[3]={ b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+    float w[3]={ c[0]-a[0], c[1]-a[1], c[2]-a[2] };
+    float* n=&fn[3*t];
+    n[0]=u[1]*w[2]-u[2]*w[1]; n[1]=u[2]*w[0]-u[0]*w[2]; n[2]=u[0]*w[1]-u[1]*w[0];
+    float L=sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+    if(L>1e-20f){ n[0]/=L; n[1]/=L; n[2]/=L; }
+  }
+  int count=0;
+  for(int h=0;h<H->n_half;h++){
+    int g=H->twin[h];
+    if(g>=0 && g<h) continue;              /* visit each edge once */
+    unsigned char mark=1;
+    if(g>=0){
+      const float* n0=&fn[3*he_face(h)]; const float* n1=&fn[3*he_face(g)];
+      mark = (n0[0]*n1[0]+n0[1]*n1[1]+n0[2]*n1[2] < cos_max);
+    }
+    crease[h]=mark;
+    if(g>=0) crease[g]=mark;
+    count+=mark;
+  }
+  free(fn);
+  return count;
+}
+
+int halfedge_count_boundary_loops(const HalfEdgeMesh* H){
+  unsigned char* seen=(unsigned char*)calloc((size_t)H->n_half+1,1);
+  if(!seen){ fprintf(stderr,"OOM halfedge\n"); exit(1); }
+  int loops=0;
+  for(int h=0;h<H->n_half;h++){
+    if(H->twin[h]>=0 || seen[h]) continue;
+    loops++;
+    /* walk the border: the next boundary half-edge starts where this one ends */
+    int b=h;
+    while(b>=0 && !seen[b]){
+      seen[b]=1;
+      int g=he_next(b);
+      for(int guard=0; H->twin[g]>=0 && guard<H->n_half; guard++) g=he_next(H->twin[g]);
+      b=(H->twin[g]<0)? g : -1;
+    }
+  }
+  free(seen);
+  return loops;
+}
@@ -0,0 +1,39 @@
+#ifndef HALFEDGE_H
+#define HALFEDGE_H
+
+#include "mesh.h"
+
+/* Array-based half-edge connectivity over a Mesh index buffer.
+   Half-edge h = 3*t + k belongs to triangle t and runs from idx[h] to idx[he_next(h)], so
+   next/prev/face are arithmetic and only the twins and one outgoing half-edge per vertex are
+   stored. Seam vertices that are duplicated in the index buffer show up as boundaries. */
+typedef struct {
+  int n_verts;
+  int n_half;          /* 3 * n_tris */
+  int* twin;           /* opposite half-edge, -1 on boundary (or non-manifold) edges */
+  int* vert_he;        /* one outgoing half-edge per vertex, the boundary one if any; -1 if unused */
+} HalfEdgeMesh;
+
+static inline int he_face(int h){ return h/3; }
+static inline int he_next(int h){ return (h%3==2)? h-2 : h+1; }
+static inline int he_prev(int h){ return (h%3==0)? h+2 : h-1; }
+static inline unsigned int he_origin(const Mesh* m, int h){ return m->idx[h]; }
+static inline unsigned int he_dest(const Mesh* m, int h){ return m->idx[he_next(h)]; }
+
+
+/* Linear time: outgoing half-edges are bucketed by origin and twins matched within a bucket. */
+HalfEdgeMesh halfedge_build(const Mesh* m);
+void         halfedge_free(HalfEdgeMesh* h);
+
+/* Next outgoing half-edge around the origin of h, -1 when a boundary is reached. */
+static inline int he_rotate(const HalfEdgeMesh* H, int h){ return H->twin[he_prev(h)]; }
+
+int halfedge_is_boundary_vertex(const HalfEdgeMesh* H, int v);
+/* Writes the one-ring of v in rotation order (up to max_out entries); returns the ring size. */
+int halfedge_vertex_ring(const HalfEdgeMesh* H, const Mesh* m, int v, unsigned int* out, int max_out);
+/* Marks (crease[h] = 1, on both halves) edges whose dihedral angle exceeds angle_deg and every
+   boundary edge; returns the number of marked edges. */
+int halfedge_mark_creases(const HalfEdgeMesh* H, const Mesh* m, float angle_deg, unsigned char* crease);
+int halfedge_count_boundary_loops(const HalfEdgeMesh* H);
+
+#endif
@@ -0,0 +1,314 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "isosurface.h"
+#include "parallel.h"
+
+/* ---- implicit fields ---- */
+
+float implicit_superquadric(const float p[3], const void* user){
+  const Superquadric* s=(const Superquadric*)user;
+  float x=fabsf(p[0]/s->a), y=fabsf(p[1]/s->b), z=fabsf(p[2]/s->c);
+  float F = powf(powf(x,2.0f/s->e2) + powf(y,2.0f/s->e2), s->e2/s->e1) + powf(z,2.0f/s->e1);
+  float m = s->a; if(s->b<m) m=s->b; if(s->c<m) m=s->c;
+  if(F<1e-20f) return -m;
+  /* F^(e1/2) grows linearly along rays from the center, so |p|(1 - F^(-e1/2)) is the radial
+     distance to the surface; the raw inside-outside value is far too non-linear to interpolate. */
+  float L=sqrtf(p[0]*p[0]+p[1]*p[1]+p[2]*p[2]);
+  return L*(1.0f - powf(F,-0.5f*s->e1));
+}
+
+float implicit_torus(const float p[3], const void* user){
+  const ImplicitTorus* t=(const ImplicitTorus*)user;
+  float q=sqrtf(p[0]*p[0]+p[1]*p[1]) - t->R;
+  return sqrtf(q*q + p[2]*p[2]) - t->r;
+}
+
+float implicit_blend(const float p[3], const void* user){
+  const ImplicitBlend* b=(const ImplicitBlend*)user;
+  float p0[3]={ p[0]-b->t0[0], p[1]-b->t0[1], p[2]-b->t0[2] };
+  float p1[3]={ p[0]-b->t1[0], p[1]-b->t1[1], p[2]-b->t1[2] };
+  float d0=b->f0(p0,b->u0), d1=b->f1(p1,b->u1);
+  if(b->k<=0.0f) return (d0<d1)? d0 : d1;
+  float h=0.5f+0.5f*(d1-d0)/b->k;
+  h = (h<0.0f)? 0.0f : (h>1.0f)? 1.0f : h;
+  return d1+(d0-d1)*h - b->k*h*(1.0f-h);
+}
+
+
+/* ---- dual contouring ---- */
+
+typedef struct {
+  float* pos; float* nor;
+  int n, cap;
+} VertBuf;
+
+typedef struct {
+  unsigned int* idx;
+  int n, cap;          /* triangles */
+} TriBuf;
+
+typedef struct {
+  ImplicitFn f; const void* user;
+  int nx, ny, nz;
+  float lo[3], step[3];
+  float* val;          /* nx*ny*nz samples */
+  int* cell_vid;       /* (nx-1)*(ny-1)*(nz-1): slab-local vertex id or -1 */
+  int* zoff;           /* per cell layer: first global id of the slab that owns it */
+  float* pos;          /* merged vertex positions, valid during the face pass */
+  VertBuf vb[PARALLEL_MAX_CHUNKS];
+  TriBuf  tb[PARALLEL_MAX_CHUNKS];
+} IsoJob;
+
+static float* grid_val(IsoJob* J, int x,int y,int z){ return &J->val[((size_t)z*J->ny + y)*J->nx + x]; }
+
+static void grid_point(const IsoJob* J, int x,int y,int z, float p[3]){
+  p[0]=J->lo[0]+J->step[0]*x; p[1]=J->lo[1]+J->step[1]*y; p[2]=J->lo[2]+J->step[2]*z;
+}
+
+static void field_gradient(const IsoJob* J, const float p[3], float n[3]){
+  for(int k=0;k<3;k++){
+    float h=0.25f*J->step[k];
+    float a[3]={p[0],p[1],p[2]}, b[3]={p[0],p[1],p[2]};
+    a[k]+=h; b[k]-=h;
+    n[k]=(J->f(a,J->user)-J->f(b,J->user))/(2.0f*h);
+  }
+  float L=sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+  if(L>1e-20f){ n[0]/=L; n[1]/=L; n[2]/=L; }
+}
+
+static void sample_slab(void* ctx, int slab, int z0, int z1){
+  IsoJob* J=(IsoJob*)ctx;
+  (void)slab;
+  for(int z=z0;z<z1;z++)
+    for(int y=0;y<J->ny;y++)
+      for(int x=0;x<J->nx;x++){
+        float p[3]; grid_point(J,x,y,z,p);
+        float v=J->f(p,J->user);
+        *grid_val(J,x,y,z) = (v==0.0f)? 1e-12f : v;   /* keep signs strict */
+      }
+}
+
+/* 3x3 symmetric solve by cofactors; 0 when singular. */
+static int solve3(const double A[6], const double b[3], double x[3]){
+  double a00=A[0], a01=A[1], a02=A[2], a11=A[3], a12=A[4], a22=A[5];
+  double c00=a11*a22-a12*a12, c01=a02*a12-a01*a22, c02=a01*a12-a02*a11;
+  double det=a00*c00+a01*c01+a02*c02;
+  if(fabs(det)<1e-18) return 0;
+  double c11=a00*a22-a02*a02, c12=a01*a02-a00*a12, c22=a00*a11-a01*a01;
+  x[0]=(c00*b[0]+c01*b[1]+c02*b[2])/det;
+  x[1]=(c01*b[0]+c11*b[1]+c12*b[2])/det;
+  x[2]=(c02*b[0]+c12*b[1]+c22*b[2])/det;
+  return 1;
+}
+
+static void vert_push(VertBuf* B, const float p[3], const float n[3]){
+  if(B->n==B->cap){
+    B->cap = B->cap ? 2*B->cap : 4096;
+    B->pos=(float*)realloc(B->pos,3*(size_t)B->cap*sizeof(float));
+    B->nor=(float*)realloc(B->nor,3*(size_t)B->cap*sizeof(float));
+    if(!B->pos||!B->nor){ fprintf(stderr,"OOM isosurface\n"); exit(1); }
+  }
+  memcpy(&B->pos[3*B->n],p,3*sizeof(float));
+  memcpy(&B->nor[3*B->n],n,3*sizeof(float));
+  B->n++;
+}
+
+static void tri_push(TriBuf* B, unsigned int a, unsigned int b, unsigned int c){
+  if(B->n==B->cap){
+    B->cap = B->cap ? 2*B->cap : 8192;
+    B->idx=(unsigned int*)realloc(B->idx,3*(size_t)B->cap*sizeof(unsigned int));
+    if(!B->idx){ fprintf(stderr,"OOM isosurface\n"); exit(1); }
+  }
+  B->idx[3*B->n]=a; B->idx[3*B->n+1]=b; B->idx[3*B->n+2]=c;
+  B->n++;
+}
+
+static const int kCubeEdges[12][2]={
+  {0,1},{2,3},{4,5},{6,7},   /* along x */
+  {0,2},{1,3},{4,6},{5,7},   /* along y */
+  {0,4},{1,5},{2,6},{3,7}    /* along z */
+};
+
+static void vertex_slab(void* ctx, int slab, int z0, int z1){
+  IsoJob* J=(IsoJob*)ctx;
+  VertBuf* B=&J->vb[slab];
+  int cx=J->nx-1, cy=J->ny-1;
+  for(int z=z0;z<z1;z++)
+  for(int y=0;y<cy;y++)
+  for(int x=0;x<cx;x++){
+    float v[8]; int inside=0;
+    for(int c=0;c<8;c++){
+      v[c]=*grid_val(J,x+(c&1),y+((c>>1)&1),z+((c>>2)&1));
+      inside|=(v[c]<0.0f)<<c;
+    }
+    int* vid=&J->cell_vid[((size_t)z*cy + y)*cx + x];
+    if(inside==0 || inside==0xff){ *vid=-1; continue; }
+
+    double ATA[6]={0,0,0,0,0,0}, ATb[3]={0,0,0};
+    float mass[3]={0,0,0}; int n_cross=0;
+    for(int e=0;e<12;e++){
+      int c0=kCubeEdges[e][0], c1=kCubeEdges[e][1];
+      if(((inside>>c0)&1)==((inside>>c1)&1)) continue;
+      float t=v[c0]/(v[c0]-v[c1]);
+      float p0[3], p1[3], p[3], n[3];
+      grid_point(J,x+(c0&1),y+((c0>>1)&1),z+((c0>>2)&1),p0);
+      grid_point(J,x+(c1&1),y+((c1>>1)&1),z+((c1>>2)&1),p1);
+      for(int k=0;k<3;k++) p[k]=p0[k]+(p1[k]-p0[k])*t;
+      field_gradient(J,p,n);
+      double d=n[0]*p[0]+n[1]*p[1]+n[2]*p[2];
+      ATA[0]+=n[0]*n[0]; ATA[1]+=n[0]*n[1]; ATA[2]+=n[0]*n[2];
+      ATA[3]+=n[1]*n[1]; ATA[4]+=n[1]*n[2]; ATA[5]+=n[2]*n[2];
+      ATb[0]+=n[0]*d; ATb[1]+=n[1]*d; ATb[2]+=n[2]*d;
+      for(int k=0;k<3;k++) mass[k]+=p[k];
+      n_cross++;
+    }
+    for(int k=0;k<3;k++) mass[k]/=(float)n_cross;
+
+    /* QEF pulled toward the mass point so flat/ill-posed cells stay well-conditioned:
+       (A^T A + l I) y = A^T b - A^T A c, with x = c + y. */
+    const double lambda=0.05*n_cross;
+    double A[6]={ ATA[0]+lambda, ATA[1], ATA[2], ATA[3]+lambda, ATA[4], ATA[5]+lambda };
+    double r[3]={
+      ATb[0]-(ATA[0]*mass[0]+ATA[1]*mass[1]+ATA[2]*mass[2]),
+      ATb[1]-(ATA[1]*mass[0]+ATA[3]*mass[1]+ATA[4]*mass[2]),
+      ATb[2]-(ATA[2]*mass[0]+ATA[4]*mass[1]+ATA[5]*mass[2])
+    };
+    double y3[3];
+    float p[3]={ mass[0], mass[1], mass[2] };
+    if(solve3(A,r,y3)){
+      float q[3]={ mass[0]+(float)y3[0], mass[1]+(float)y3[1], mass[2]+(float)y3[2] };
+      float c0[3]; grid_point(J,x,y,z,c0);
+      int ok=1;
+      for(int k=0;k<3;k++)
+        if(q[k]<c0[k]-0.5f*J->step[k] || q[k]>c0[k]+1.5f*J->step[k]) ok=0;
+      if(ok){ p[0]=q[0]; p[1]=q[1]; p[2]=q[2]; }
+    }
+    float n[3];
+    field_gradient(J,p,n);
+    *vid=B->n;
+    vert_push(B,p,n);
+  }
+}
+
+static int cell_global(const IsoJob* J, int x,int y,int z){
+  int cx=J->nx-1, cy=J->ny-1;
+  return J->zoff[z] + J->cell_vid[((size_t)z*cy + y)*cx + x];
+}
+
+/* Quad over the four cells around a sign-changing edge, split along the shorter diagonal.
+   c[] is counter-clockwise seen from the positive end of the edge axis. */
+static float dist2(const float* a, const float* b){
+  float d0=a[0]-b[0], d1=a[1]-b[1], d2=a[2]-b[2];
+  return d0*d0+d1*d1+d2*d2;
+}
+
+static void emit_quad(const IsoJob* J, TriBuf* B, const int c[4], int flip){
+  unsigned int v[4];
+  for(int i=0;i<4;i++) v[i]=(unsigned int)c[i];
+  if(flip){ unsigned int t=v[1]; v[1]=v[3]; v[3]=t; }
+  const float* P=J->pos;
+  if(dist2(&P[3*v[0]],&P[3*v[2]]) <= dist2(&P[3*v[1]],&P[3*v[3]])){
+    tri_push(B,v[0],v[1],v[2]);
+    tri_push(B,v[0],v[2],v[3]);
+  } else {
+    tri_push(B,v[0],v[1],v[3]);
+    tri_push(B,v[1],v[2],v[3]);
+  }
+}
+
+static void face_slab(void* ctx, int slab, int z0, int z1){
+  IsoJob* J=(IsoJob*)ctx;
+  TriBuf* B=&J->tb[slab];
+  for(int z=z0;z<z1;z++)
+  for(int y=0;y<J->ny;y++)
+  for(int x=0;x<J->nx;x++){
+    float v0=*grid_val(J,x,y,z);
+    int c[4];
+    /* x edge: cells around it in the (y,z) plane */
+    if(x+1<J->nx && y>=1 && y<J->ny-1 && z>=1 && z<J->nz-1){
+      float v1=*grid_val(J,x+1,y,z);
+      if((v0<0.0f)!=(v1<0.0f)){
+        c[0]=cell_global(J,x,y-1,z-1); c[1]=cell_global(J,x,y,z-1);
+        c[2]=cell_global(J,x,y,z);     c[3]=cell_global(J,x,y-1,z);
+        emit_quad(J,B,c,v1<0.0f);
+      }
+    }
+    /* y edge: (z,x) plane */
+    if(y+1<J->ny && x>=1 && x<J->nx-1 && z>=1 && z<J->nz-1){
+      float v1=*grid_val(J,x,y+1,z);
+      if((v0<0.0f)!=(v1<0.0f)){
+        c[0]=cell_global(J,x-1,y,z-1); c[1]=cell_global(J,x-1,y,z);
+        c[2]=cell_global(J,x,y,z);     c[3]=cell_global(J,x,y,z-1);
+        emit_quad(J,B,c,v1<0.0f);
+      }
+    }
+    /* z edge: (x,y) plane */
+    if(z+1<J->nz && x>=1 && x<J->nx-1 && y>=1 && y<J->ny-1){
+      float v1=*grid_val(J,x,y,z+1);
+      if((v0<0.0f)!=(v1<0.0f)){
+        c[0]=cell_global(J,x-1,y-1,z); c[1]=cell_global(J,x,y-1,z);
+        c[2]=cell_global(J,x,y,z);     c[3]=cell_global(J,x-1,y,z);
+        emit_quad(J,B,c,v1<0.0f);
+      }
+    }
+  }
+}
+
+Mesh mesh_make_implicit(ImplicitFn f, const void* user, const float lo[3], const float hi[3],
+                        int nx,int ny,int nz, int n_threads){
+  if(nx<2) nx=2;
+  if(ny<2) ny=2;
+  if(nz<2) nz=2;
+  n_threads=parallel_chunks(nz-1,n_threads);
+
+  IsoJob* J=(IsoJob*)calloc(1,sizeof(IsoJob));
+  if(!J){ fprintf(stderr,"OOM isosurface\n"); exit(1); }
+  J->f=f; J->user=user; J->nx=nx; J->ny=ny; J->nz=nz;
+  J->lo[0]=lo[0]; J->lo[1]=lo[1]; J->lo[2]=lo[2];
+  J->step[0]=(hi[0]-lo[0])/(nx-1); J->step[1]=(hi[1]-lo[1])/(ny-1); J->step[2]=(hi[2]-lo[2])/(nz-1);
+  J->val=(float*)malloc((size_t)nx*ny*nz*sizeof(float));
+  J->cell_vid=(int*)malloc((size_t)(nx-1)*(ny-1)*(nz-1)*sizeof(int));
+  J->zoff=(int*)malloc((size_t)(nz-1)*sizeof(int));
+  if(!J->val||!J->cell_vid||!J->zoff){ fprintf(stderr,"OOM isosurface\n"); exit(1); }
+
+  parallel_for(nz,n_threads,sample_slab,J);
+  parallel_for(nz-1,n_threads,vertex_slab,J);
+
+  /* merge: every slab's vertices follow the previous slab's */
+  int total_v=0;
+  for(int s=0;s<n_threads;s++){
+    int z0=parallel_chunk_begin(nz-1,s,n_threads), z1=parallel_chunk_begin(nz-1,s+1,n_threads);
+    for(int z=z0;z<z1;z++) J->zoff[z]=total_v;
+    total_v+=J->vb[s].n;
+  }
+  float* pos=(float*)malloc(3*(size_t)(total_v>0?total_v:1)*sizeof(float));
+  float* nor=(float*)malloc(3*(size_t)(total_v>0?total_v:1)*sizeof(float));
+  if(!pos||!nor){ fprintf(stderr,"OOM isosurface\n"); exit(1); }
+  for(int s=0,v=0;s<n_threads;s++){
+    memcpy(&pos[3*v],J->vb[s].pos,3*(size_t)J->vb[s].n*sizeof(float));
+    memcpy(&nor[3*v],J->vb[s].nor,3*(size_t)J->vb[s].n*sizeof(float));
+    v+=J->vb[s].n;
+    free(J->vb[s].pos); free(J->vb[s].nor);
+  }
+  J->pos=pos;
+
+  parallel_for(nz,n_threads,face_slab,J);
+  int total_t=0;
+  for(int s=0;s<n_threads;s++) total_t+=J->tb[s].n;
+
+  Mesh m=mesh_alloc(total_v,total_t);
+  memcpy(m.pos,pos,3*(size_t)total_v*sizeof(float));
+  memcpy(m.nor,nor,3*(size_t)total_v*sizeof(float));
+  for(int s=0,t=0;s<n_threads;s++){
+    memcpy(&m.idx[3*t],J->tb[s].idx,3*(size_t)J->tb[s].n*sizeof(unsigned int));
+    t+=J->tb[s].n;
+    free(J->tb[s].idx);
+  }
+  free(pos); free(nor);
+  free(J->val); free(J->cell_vid); free(J->zoff); free(J);
+  return m;
+}
@@ -0,0 +1,34 @@
+#ifndef ISOSURFACE_H
+#define ISOSURFACE_H
+
+#include "mesh.h"
+
+/* Signed field: negative inside, positive outside, roughly metric near the surface. */
+typedef float (*ImplicitFn)(const float p[3], const void* user);
+
+/* Barr superquadric with the same a,b,c,e1,e2 meaning as mesh_make_superellipsoid. */
+typedef struct { float a,b,c, e1,e2; } Superquadric;
+
+/* Torus around the z axis, like mesh_make_twisted_torus without the twist. */
+typedef struct { float R, r; } ImplicitTorus;
+
+/* Smooth union of two translated fields; k is the blend radius. */
+typedef struct {
+  ImplicitFn f0; const void* u0; float t0[3];
+  ImplicitFn f1; const void* u1; float t1[3];
+  float k;
+} ImplicitBlend;
+
+float implicit_superquadric(const float p[3], const void* sq);
+float implicit_torus(const float p[3], const void* torus);
+float implicit_blend(const float p[3], const void* blend);
+
+
+/* Dual contouring on an nx*ny*nz sample grid spanning [lo,hi]: one QEF-placed vertex per
+   sign-changing cell, one quad per sign-changing grid edge. z-slabs are sampled, solved and
+   stitched on n_threads threads (<=0: one per core); vertices are shared across slabs.
+   The field must be positive on the grid border for the result to be closed. */
+Mesh mesh_make_implicit(ImplicitFn f, const void* user, const float lo[3], const float hi[3],
+                        int nx,int ny,int nz, int n_threads);
+
+#endif
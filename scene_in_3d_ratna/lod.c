@@ -0,0 +1,387 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lod.h"
+#include "halfedge.h"
+
+/* Quadric-error-metric simplification (Garland & Heckbert '97): every vertex carries the sum of
+   the squared distances to the planes of its faces; an edge collapse costs v^T (Qa+Qb) v at the
+   best position v. Edges live in a lazy min-heap; stale entries are skipped via per-vertex stamps. */
+
+#define BOUNDARY_WEIGHT 100.0
+
+typedef struct { double q[10]; } Quadric;   /* aa ab ac ad bb bc bd cc cd dd */
+
+typedef struct { int* f; int n, cap; } FaceList;
+
+typedef struct {
+  double cost;
+  float  p[3];
+  int    a, b;
+  unsigned int sa, sb;
+} EdgeEntry;
+
+typedef struct { EdgeEntry* e; int n, cap; } EdgeHeap;
+
+
+static void quadric_plane(Quadric* Q, double a,double b,double c,double d, double w){
+  Q->q[0]+=w*a*a; Q->q[1]+=w*a*b; Q->q[2]+=w*a*c; Q->q[3]+=w*a*d;
+  Q->q[4]+=w*b*b; Q->q[5]+=w*b*c; Q->q[6]+=w*b*d;
+  Q->q[7]+=w*c*c; Q->q[8]+=w*c*d;
+  Q->q[9]+=w*d*d;
+}
+
+static void quadric_add(Quadric* dst, const Quadric* a, const Quadric* b){
+  for(int i=0;i<10;i++) dst->q[i]=a->q[i]+b->q[i];
+}
+
+static double quadric_eval(const Quadric* Q, const float v[3]){
+  const double* q=Q->q;
+  double x=v[0], y=v[1], z=v[2];
+  return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+       + q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+       + q[7]*z*z + 2*q[8]*z
+       + q[9];
+}
+
+/* Solves the 3x3 gradient system for the error minimum; 0 when (near) singular. */
+static int quadric_optimum(const Quadric* Q, float out[3]){
+  const double* q=Q->q;
+  double a00=q[0], a01=q[1], a02=q[2], a11=q[4], a12=q[5], a22=q[7];
+  double b0=-q[3], b1=-q[6], b2=-q[8];
+  double c00=a11*a22-a12*a12, c01=a02*a12-a01*a22, c02=a01*a12-a02*a11;
+  double det=a00*c00 + a01*c01 + a02*c02;
+  double scale=fabs(a00)+fabs(a11)+fabs(a22);
+  if(fabs(det) <= 1e-10*scale*scale*scale || scale==0.0) return 0;
+  double c11=a00*a22-a02*a02, c12=a01*a02-a00*a12, c22=a00*a11-a01*a01;
+  double inv=1.0/det;
+  out[0]=(float)((c00*b0 + c01*b1 + c02*b2)*inv);
+  out[1]=(float)((c01*b0 + c11*b1 + c12*b2)*inv);
+  out[2]=(float)((c02*b0 + c12*b1 + c22*b2)*inv);
+  return 1;
+}
+
+static void face_list_push(FaceList* L, int f){
+  if(L->n==L->cap){
+    L->cap = L->cap ? 2*L->cap : 8;
+    L->f = (int*)realloc(L->f, (size_t)L->cap*sizeof(int));
+    if(!L->f){ fprintf(stderr,"OOM lod\n"); exit(1); }
+  }
+  L->f[L->n++]=f;
+}
+
+static void heap_push(EdgeHeap* H, EdgeEntry e){
+  if(H->n==H->cap){
+    H->cap = H->cap ? 2*H->cap : 1024;
+    H->e = (EdgeEntry*)realloc(H->e, (size_t)H->cap*sizeof(EdgeEntry));
+    if(!H->e){ fprintf(stderr,"OOM lod\n"); exit(1); }
+  }
+  int i=H->n++;
+  while(i>0){
+    int p=(i-1)/2;
+    if(H->e[p].cost <= e.cost) break;
+    H->e[i]=H->e[p]; i=p;
+  }
+  H->e[i]=e;
+}
+
+static EdgeEntry heap_pop(EdgeHeap* H){
+  EdgeEntry top=H->e[0];
+  EdgeEntry last=H->e[--H->n];
+  int i=0;
+  for(;;){
+    int c=2*i+1;
+    if(c>=H->n) break;
+    if(c+1<H->n && H->e[c+1].cost < H->e[c].cost) c++;
+    if(last.cost <= H->e[c].cost) break;
+    H->e[i]=H->e[c]; i=c;
+  }
+  if(H->n>0) H->e[i]=last;
+  return top;
+}
+
+static void face_normal(const float* a,const float* b,const float* c, double n[3]){
+  double u[3]={ b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+  double v[3]={ c[0]-a[0], c[1]-a[1], c[2]-a[2] };
+  n[0]=u[1]*v[2]-u[2]*v[1];
+  n[1]=u[2]*v[0]-u[0]*v[2];
+  n[2]=u[0]*v[1]-u[1]*v[0];
+}
+
+typedef struct {
+  int nv, nt, live_tris;
+  float* P;
+  int* T;
+  unsigned char* face_dead;
+  unsigned char* vert_dead;
+  unsigned char* border;       /* vertex lies on an open boundary */
+  unsigned int* stamp;
+  int* mark;
+  int  mark_tag;
+  Quadric* Q;
+  FaceList* adj;
+  EdgeHeap heap;
+} Simplifier;
+
+static void push_edge(Simplifier* S, int a, int b){
+  Quadric q; quadric_add(&q,&S->Q[a],&S->Q[b]);
+  EdgeEntry e;
+  if(!quadric_optimum(&q,e.p)){
+    const float* pa=&S->P[3*a]; const float* pb=&S->P[3*b];
+    float mid[3]={ 0.5f*(pa[0]+pb[0]), 0.5f*(pa[1]+pb[1]), 0.5f*(pa[2]+pb[2]) };
+    double ca=quadric_eval(&q,pa), cb=quadric_eval(&q,pb), cm=quadric_eval(&q,mid);
+    const float* best = (ca<=cb && ca<=cm) ? pa : (cb<=cm ? pb : mid);
+    e.p[0]=best[0]; e.p[1]=best[1]; e.p[2]=best[2];
+  }
+  e.cost=quadric_eval(&q,e.p);
+  if(e.cost<0.0) e.cost=0.0;
+  e.a=a; e.b=b; e.sa=S->stamp[a]; e.sb=S->stamp[b];
+  heap_push(&S->heap,e);
+}
+
+static int face_has(const Simplifier* S, int f, int v){
+  const int* t=&S->T[3*f];
+  return t[0]==v || t[1]==v || t[2]==v;
+}
+
+/* Link condition: a and b may share only the neighbours opposite the edge in its faces (two
+   inside, one on a boundary), otherwise the collapse pinches the surface into a non-manifold fin.
+   Two boundary vertices may only merge along their boundary edge, or the border gets pinched. */
+static int collapse_keeps_manifold(Simplifier* S, int a, int b){
+  int tag_a=++S->mark_tag, edge_faces=0;
+  const FaceList* La=&S->adj[a];
+  for(int k=0;k<La->n;k++){
+    int f=La->f[k]; if(S->face_dead[f]) continue;
+    edge_faces+=face_has(S,f,b);
+    for(int c=0;c<3;c++){ int v=S->T[3*f+c]; if(v!=a) S->mark[v]=tag_a; }
+  }
+  int tag_b=++S->mark_tag, shared=0;
+  const FaceList* Lb=&S->adj[b];
+  for(int k=0;k<Lb->n;k++){
+    int f=Lb->f[k]; if(S->face_dead[f]) continue;
+    for(int c=0;c<3;c++){
+      int v=S->T[3*f+c];
+      if(v==a || v==b) continue;
+      if(S->mark[v]==tag_a){ shared++; S->mark[v]=tag_b; }
+    }
+  }
+  if(S->border[a] && S->border[b] && edge_faces!=1) return 0;
+  return shared<=edge_faces;
+}
+
+/* Rejects collapses that flip any surviving face around a or b. */
+static int collapse_keeps_orientation(const Simplifier* S, int a, int b, const float p[3]){
+  int ends[2]={a,b};
+  for(int e=0;e<2;e++){
+    int v=ends[e], other=ends[1-e];
+    const FaceList* L=&S->adj[v];
+    for(int k=0;k<L->n;k++){
+      int f=L->f[k];
+      if(S->face_dead[f] || face_has(S,f,other)) continue;
+      const float* q[3]; const float* q2[3];
+      for(int c=0;c<3;c++){
+        int w=S->T[3*f+c];
+        q[c]=&S->P[3*w];
+        q2[c]=(w==v)? p : q[c];
+      }
+      double n0[3], n1[3];
+      face_normal(q[0],q[1],q[2],n0);
+      face_normal(q2[0],q2[1],q2[2],n1);
+      double d=n0[0]*n1[0]+n0[1]*n1[1]+n0[2]*n1[2];
+      double l1=n1[0]*n1[0]+n1[1]*n1[1]+n1[2]*n1[2];
+      if(d<=0.0 || l1<=1e-24) return 0;
+    }
+  }
+  return 1;
+}
+
+static void collapse_edge(Simplifier* S, int a, int b, const float p[3]){
+  S->P[3*a]=p[0]; S->P[3*a+1]=p[1]; S->P[3*a+2]=p[2];
+  quadric_add(&S->Q[a],&S->Q[a],&S->Q[b]);
+  S->vert_dead[b]=1;
+  S->border[a]|=S->border[b];
+  S->stamp[a]++;
+
+  FaceList* Lb=&S->adj[b];
+  for(int k=0;k<Lb->n;k++){
+    int f=Lb->f[k];
+    if(S->face_dead[f]) continue;
+    if(face_has(S,f,a)){ S->face_dead[f]=1; S->live_tris--; continue; }
+    for(int c=0;c<3;c++) if(S->T[3*f+c]==b) S->T[3*f+c]=a;
+    face_list_push(&S->adj[a],f);
+  }
+  free(Lb->f); Lb->f=NULL; Lb->n=Lb->cap=0;
+
+  FaceList* La=&S->adj[a];
+  int w=0;
+  for(int k=0;k<La->n;k++) if(!S->face_dead[La->f[k]]) La->f[w++]=La->f[k];
+  La->n=w;
+
+  int tag=++S->mark_tag;
+  S->mark[a]=tag;
+  for(int k=0;k<La->n;k++){
+    int f=La->f[k];
+    for(int c=0;c<3;c++){
+      int v=S->T[3*f+c];
+      if(S->mark[v]==tag) continue;
+      S->mark[v]=tag;
+      push_edge(S,a,v);
+    }
+  }
+}
+
+Mesh mesh_simplify(const Mesh* src, int target_tris){
+  Simplifier S;
+  memset(&S,0,sizeof(S));
+
+  int* remap=(int*)malloc((size_t)(src->n_verts>0?src->n_verts:1)*sizeof(int));
+  if(!remap){ fprintf(stderr,"OOM lod\n"); exit(1); }
+  S.nv=mesh_weld_vertices(src,&S.P,remap);
+
+  S.T=(int*)malloc(3*(size_t)(src->n_tris>0?src->n_tris:1)*sizeof(int));
+  if(!S.T){ fprintf(stderr,"OOM lod\n"); exit(1); }
+  for(int t=0;t<src->n_tris;t++){
+    int i0=remap[src->idx[3*t]], i1=remap[src->idx[3*t+1]], i2=remap[src->idx[3*t+2]];
+    if(i0==i1 || i1==i2 || i0==i2) continue;   /* pole / seam slivers */
+    S.T[3*S.nt]=i0; S.T[3*S.nt+1]=i1; S.T[3*S.nt+2]=i2; S.nt++;
+  }
+  free(remap);
+  S.live_tris=S.nt;
+
+  S.face_dead=(unsigned char*)calloc((size_t)S.nt+1,1);
+  S.vert_dead=(unsigned char*)calloc((size_t)S.nv+1,1);
+  S.border=(unsigned char*)calloc((size_t)S.nv+1,1);
+  S.stamp=(unsigned int*)calloc((size_t)S.nv+1,sizeof(unsigned int));
+  S.mark=(int*)calloc((size_t)S.nv+1,sizeof(int));
+  S.Q=(Quadric*)calloc((size_t)S.nv+1,sizeof(Quadric));
+  S.adj=(FaceList*)calloc((size_t)S.nv+1,sizeof(FaceList));
+  if(!S.face_dead||!S.vert_dead||!S.border||!S.stamp||!S.mark||!S.Q||!S.adj){ fprintf(stderr,"OOM lod\n"); exit(1); }
+
+  for(int f=0;f<S.nt;f++){
+    const int* t=&S.T[3*f];
+    double n[3];
+    face_normal(&S.P[3*t[0]],&S.P[3*t[1]],&S.P[3*t[2]],n);
+    double len=sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+    if(len>1e-20){
+      double a=n[0]/len, b=n[1]/len, c=n[2]/len;
+      const float* p=&S.P[3*t[0]];
+      double d=-(a*p[0]+b*p[1]+c*p[2]);
+      for(int k=0;k<3;k++) quadric_plane(&S.Q[t[k]],a,b,c,d,0.5*len);
+    }
+    for(int k=0;k<3;k++) face_list_push(&S.adj[t[k]],f);
+  }
+
+  /* Welded connectivity: every edge once, open edges get a heavily weighted plane perpendicular
+     to their face so borders stay put. */
+  Mesh w=mesh_alloc(S.nv,S.nt);
+  memcpy(w.pos,S.P,3*(size_t)S.nv*sizeof(float));
+  for(int i=0;i<3*S.nt;i++) w.idx[i]=(unsigned int)S.T[i];
+  HalfEdgeMesh H=halfedge_build(&w);
+  for(int v=0;v<S.nv;v++) S.border[v]=(unsigned char)halfedge_is_boundary_vertex(&H,v);
+  for(int h=0;h<H.n_half;h++){
+    int g=H.twin[h];
+    if(g>=0 && g<h) continue;
+    int a=(int)he_origin(&w,h), b=(int)he_dest(&w,h);
+    if(g<0){
+      const int* t=&S.T[3*he_face(h)];
+      double n[3], e[3], m[3];
+      face_normal(&S.P[3*t[0]],&S.P[3*t[1]],&S.P[3*t[2]],n);
+      for(int k=0;k<3;k++) e[k]=S.P[3*b+k]-S.P[3*a+k];
+      m[0]=e[1]*n[2]-e[2]*n[1]; m[1]=e[2]*n[0]-e[0]*n[2]; m[2]=e[0]*n[1]-e[1]*n[0];
+      double ml=sqrt(m[0]*m[0]+m[1]*m[1]+m[2]*m[2]);
+      if(ml>1e-20){
+        m[0]/=ml; m[1]/=ml; m[2]/=ml;
+        double d=-(m[0]*S.P[3*a]+m[1]*S.P[3*a+1]+m[2]*S.P[3*a+2]);
+        double wt=BOUNDARY_WEIGHT*(e[0]*e[0]+e[1]*e[1]+e[2]*e[2]);
+        quadric_plane(&S.Q[a],m[0],m[1],m[2],d,wt);
+        quadric_plane(&S.Q[b],m[0],m[1],m[2],d,wt);
+      }
+    }
+  }
+  for(int h=0;h<H.n_half;h++){
+    int g=H.twin[h];
+    if(g>=0 && g<h) continue;
+    push_edge(&S,(int)he_origin(&w,h),(int)he_dest(&w,h));
+  }
+  halfedge_free(&H);
+  mesh_free(&w);
+
+  if(target_tris<1) target_tris=1;
+  while(S.live_tris>target_tris && S.heap.n>0){
+    EdgeEntry e=heap_pop(&S.heap);
+    if(S.vert_dead[e.a] || S.vert_dead[e.b]) continue;
+    if(S.stamp[e.a]!=e.sa || S.stamp[e.b]!=e.sb) continue;
+    if(!collapse_keeps_manifold(&S,e.a,e.b)) continue;
+    if(!collapse_keeps_orientation(&S,e.a,e.b,e.p)) continue;
+    collapse_edge(&S,e.a,e.b,e.p);
+  }
+
+  /* Compact surviving vertices/faces into a fresh Mesh. */
+  int* newid=S.mark;
+  int nv=0;
+  for(int v=0;v<S.nv;v++) newid[v]=-1;
+  for(int f=0;f<S.nt;f++){
+    if(S.face_dead[f]) continue;
+    for(int c=0;c<3;c++){ int v=S.T[3*f+c]; if(newid[v]<0) newid[v]=nv++; }
+  }
+  Mesh out=mesh_alloc(nv,S.live_tris);
+  for(int v=0;v<S.nv;v++){
+    if(newid[v]<0) continue;
+    memcpy(&out.pos[3*newid[v]],&S.P[3*v],3*sizeof(float));
+  }
+  int t=0;
+  for(int f=0;f<S.nt;f++){
+    if(S.face_dead[f]) continue;
+    for(int c=0;c<3;c++) out.idx[3*t+c]=(unsigned int)newid[S.T[3*f+c]];
+    t++;
+  }
+  mesh_compute_normals(&out);
+
+  for(int v=0;v<S.nv;v++) free(S.adj[v].f);
+  free(S.adj); free(S.Q); free(S.mark); free(S.stamp); free(S.border); free(S.vert_dead); free(S.face_dead);
+  free(S.T); free(S.P); free(S.heap.e);
+  return out;
+}
+
+
+MeshLod mesh_lod_build(const Mesh* src, const float* ratios, int n_ratios){
+  MeshLod lod;
+  memset(&lod,0,sizeof(lod));
+  if(n_ratios>MESH_LOD_MAX) n_ratios=MESH_LOD_MAX;
+  if(n_ratios<1) n_ratios=1;
+
+  lod.level[0]=mesh_simplify(src,src->n_tris);
+  lod.ratio[0]=1.0f;
+  lod.n_levels=1;
+  mesh_bounds(&lod.level[0],lod.center,&lod.radius);
+
+  int base=lod.level[0].n_tris;
+  for(int i=1;i<n_ratios;i++){
+    int target=(int)(ratios[i]*(float)base);
+    const Mesh* prev=&lod.level[lod.n_levels-1];
+    if(target>=prev->n_tris) continue;
+    lod.level[lod.n_levels]=mesh_simplify(prev,target);
+    lod.ratio[lod.n_levels]=(base>0)? (float)lod.level[lod.n_levels].n_tris/(float)base : 0.0f;
+    lod.n_levels++;
+  }
+  return lod;
+}
+
+void mesh_lod_free(MeshLod* lod){
+  if(!lod) return;
+  for(int i=0;i<lod->n_levels;i++) mesh_free(&lod->level[i]);
+  memset(lod,0,sizeof(*lod));
+}
+
+const Mesh* mesh_lod_select(const MeshLod* lod, float screen_px, float ref_px){
+  /* Triangle count scales with projected area, i.e. with the square of the diameter. */
+  float need = (ref_px>0.0f) ? (screen_px/ref_px)*(screen_px/ref_px) : 1.0f;
+  int pick=0;
+  for(int i=lod->n_levels-1;i>0;i--){
+    if(lod->ratio[i]>=need){ pick=i; break; }
+  }
+  return &lod->level[pick];
+}
@@ -0,0 +1,30 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include "mesh.h"
+
+#define MESH_LOD_MAX 8
+
+/* Chain of progressively simplified copies of one mesh; level[0] is the full-detail mesh. */
+typedef struct {
+  int   n_levels;
+  Mesh  level[MESH_LOD_MAX];
+  float ratio[MESH_LOD_MAX];   /* triangle fraction of each level relative to level[0] */
+  float center[3];             /* bounding sphere of level[0], object space */
+  float radius;
+} MeshLod;
+
+
+/* Garland-Heckbert quadric-error edge collapse down to at most target_tris triangles.
+   Coincident seam vertices are welded first, so the result is closed where the source was. */
+Mesh   mesh_simplify(const Mesh* src, int target_tris);
+
+/* ratios[] are descending triangle fractions, e.g. {1.0, 0.5, 0.25, 0.1}. */
+MeshLod mesh_lod_build(const Mesh* src, const float* ratios, int n_ratios);
+void    mesh_lod_free(MeshLod* lod);
+
+/* Picks the coarsest level whose triangle density still covers a projected diameter of
+   screen_px pixels; ref_px is the diameter at which level[0] is needed. */
+const Mesh* mesh_lod_select(const MeshLod* lod, float screen_px, float ref_px);
+
+#endif
@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include "mesh.h"
+#include "fastpow.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -49,6 +50,117 @@ void mesh_free(Mesh* m){
   memset(m,0,sizeof(*m));
 }
 
+Mesh mesh_alloc(int n_verts,int n_tris){
+  Mesh m={0};
+  m.n_verts = n_verts;
+  m.n_tris  = n_tris;
+  m.pos = (float*)calloc(3*(size_t)(n_verts>0?n_verts:1),sizeof(float));
+  m.nor = (float*)calloc(3*(size_t)(n_verts>0?n_verts:1),sizeof(float));
+  m.idx = (unsigned int*)calloc(3*(size_t)(n_tris>0?n_tris:1),sizeof(unsigned int));
+  if(!m.pos||!m.nor||!m.idx){ fprintf(stderr,"OOM mesh\n"); exit(1); }
+  return m;
+}
+
+void mesh_compute_normals(Mesh* m){
+  memset(m->nor,0,3*(size_t)m->n_verts*sizeof(float));
+  for(int t=0;t<m->n_tris;t++){
+    unsigned int i0=m->idx[3*t+0], i1=m->idx[3*t+1], i2=m->idx[3*t+2];
+    float n[3];
+    tri_normal(&m->pos[3*i0],&m->pos[3*i1],&m->pos[3*i2],n);
+    add_nor(m->nor,i0,n); add_nor(m->nor,i1,n); add_nor(m->nor,i2,n);
+  }
+  normalize_all(m->nor, m->n_verts);
+}
+
+void mesh_bounds(const Mesh* m, float center[3], float* radius){
+  float lo[3]={0,0,0}, hi[3]={0,0,0};
+  for(int i=0;i<m->n_verts;i++){
+    for(int k=0;k<3;k++){
+      float v=m->pos[3*i+k];
+      if(i==0||v<lo[k]) lo[k]=v;
+      if(i==0||v>hi[k]) hi[k]=v;
+    }
+  }
+  for(int k=0;k<3;k++) center[k]=0.5f*(lo[k]+hi[k]);
+  float r2=0.0f;
+  for(int i=0;i<m->n_verts;i++){
+    float dx=m->pos[3*i+0]-center[0], dy=m->pos[3*i+1]-center[1], dz=m->pos[3*i+2]-center[2];
+    float d2=dx*dx+dy*dy+dz*dz;
+    if(d2>r2) r2=d2;
+  }
+  *radius=sqrtf(r2);
+}
+
+static unsigned int cell_hash(int x,int y,int z){
+  return (unsigned int)x*73856093u ^ (unsigned int)y*19349663u ^ (unsigned int)z*83492791u;
+}
+
+int mesh_weld_vertices(const Mesh* m, float** out_pos, int* remap){
+  float c[3], r;
+  mesh_bounds(m,c,&r);
+  float eps = (r>0.0f) ? r*1e-5f : 1e-6f;
+  float inv = 1.0f/(4.0f*eps);
+
+  int nb=1; while(nb < 2*m->n_verts) nb<<=1;
+  int* head=(int*)malloc((size_t)nb*sizeof(int));
+  int* next=(int*)malloc((size_t)m->n_verts*sizeof(int));
+  int* cell=(int*)malloc(3*(size_t)m->n_verts*sizeof(int));
+  float* P=(float*)malloc(3*(size_t)m->n_verts*sizeof(float));
+  if(!head||!next||!cell||!P){ fprintf(stderr,"OOM weld\n"); exit(1); }
+  for(int i=0;i<nb;i++) head[i]=-1;
+
+  int nw=0;
+  for(int i=0;i<m->n_verts;i++){
+    const float* p=&m->pos[3*i];
+    int cx=(int)floorf(p[0]*inv), cy=(int)floorf(p[1]*inv), cz=(int)floorf(p[2]*inv);
+    int found=-1;
+    for(int dz=-1;dz<=1 && found<0;dz++)
+    for(int dy=-1;dy<=1 && found<0;dy++)
+    for(int dx=-1;dx<=1 && found<0;dx++){
+      int b=(int)(cell_hash(cx+dx,cy+dy,cz+dz)&(unsigned int)(nb-1));
+      for(int w=head[b]; w>=0; w=next[w]){
+        if(cell[3*w]!=cx+dx || cell[3*w+1]!=cy+dy || cell[3*w+2]!=cz+dz) continue;
+        float ex=P[3*w]-p[0], ey=P[3*w+1]-p[1], ez=P[3*w+2]-p[2];
+        if(ex*ex+ey*ey+ez*ez <= eps*eps){ found=w; break; }
+      }
+    }
+    if(found<0){
+      found=nw++;
+      P[3*found]=p[0]; P[3*found+1]=p[1]; P[3*found+2]=p[2];
+      cell[3*found]=cx; cell[3*found+1]=cy; cell[3*found+2]=cz;
+      int b=(int)(cell_hash(cx,cy,cz)&(unsigned int)(nb-1));
+      next[found]=head[b]; head[b]=found;
+    }
+    remap[i]=found;
+  }
+  free(head); free(next); free(cell);
+  *out_pos=P;
+  return nw;
+}
+
+Mesh mesh_weld(const Mesh* m){
+  int* remap=(int*)malloc((size_t)(m->n_verts>0?m->n_verts:1)*sizeof(int));
+  if(!remap){ fprintf(stderr,"OOM weld\n"); exit(1); }
+  float* P=NULL;
+  int nv=mesh_weld_vertices(m,&P,remap);
+  int nt=0;
+  for(int t=0;t<m->n_tris;t++){
+    int i0=remap[m->idx[3*t]], i1=remap[m->idx[3*t+1]], i2=remap[m->idx[3*t+2]];
+    if(i0!=i1 && i1!=i2 && i0!=i2) nt++;
+  }
+  Mesh w=mesh_alloc(nv,nt);
+  memcpy(w.pos,P,3*(size_t)nv*sizeof(float));
+  nt=0;
+  for(int t=0;t<m->n_tris;t++){
+    int i0=remap[m->idx[3*t]], i1=remap[m->idx[3*t+1]], i2=remap[m->idx[3*t+2]];
+    if(i0==i1 || i1==i2 || i0==i2) continue;
+    w.idx[3*nt]=i0; w.idx[3*nt+1]=i1; w.idx[3*nt+2]=i2; nt++;
+  }
+  free(P); free(remap);
+  mesh_compute_normals(&w);
+  return w;
+}
+
 void mesh_draw_triangles(const Mesh* m){
   glBegin(GL_TRIANGLES);
   for(int t=0;t<m->n_tris;t++){
@@ -64,92 +176,92 @@ void mesh_draw_triangles(const Mesh* m){
 }
 
 
+/* Two triangles per (u,v) cell, counter-clockwise seen from outside. */
+static void grid_indices(Mesh* m, int Nu,int Nv){
+  int t=0;
+  for(int j=0;j<Nv-1;j++){
+    for(int i=0;i<Nu-1;i++){
+      int i0=j*Nu+i, i1=j*Nu+i+1, i2=(j+1)*Nu+i, i3=(j+1)*Nu+i+1;
+      m->idx[3*t+0]=i0; m->idx[3*t+1]=i2; m->idx[3*t+2]=i1; t++;
+      m->idx[3*t+0]=i1; m->idx[3*t+1]=i2; m->idx[3*t+2]=i3; t++;
+    }
+  }
+}
+
 Mesh mesh_make_twisted_torus(int Nu,int Nv, float R,float r, int twist_k){
-  Mesh m={0};
-  m.n_verts = Nu*Nv;
-  m.n_tris  = (Nu-1)*(Nv-1)*2;
-  m.pos = (float*)calloc(3*m.n_verts,sizeof(float));
-  m.nor = (float*)calloc(3*m.n_verts,sizeof(float));
-  m.idx = (unsigned int*)calloc(3*m.n_tris,sizeof(unsigned int));
-  if(!m.pos||!m.nor||!m.idx){ fprintf(stderr,"OOM torus\n"); exit(1); }
+  Mesh m = mesh_alloc(Nu*Nv, (Nu-1)*(Nv-1)*2);
+  grid_indices(&m, Nu,Nv);
+  mesh_update_twisted_torus(&m, Nu,Nv, R,r, (float)twist_k);
+  return m;
+}
 
+void mesh_update_twisted_torus(Mesh* m, int Nu,int Nv, float R,float r, float twist){
   for(int j=0;j<Nv;j++){
     float v = (float)j/(Nv-1)*2.0f*(float)M_PI;
+    float cv=cosf(v),     sv=sinf(v);
     for(int i=0;i<Nu;i++){
       float u = (float)i/(Nu-1)*2.0f*(float)M_PI;
-      float theta = u + twist_k*v;
+      float theta = u + twist*v;
       float ct=cosf(theta), st=sinf(theta);
-      float cv=cosf(v),     sv=sinf(v);
       float x=(R + r*ct)*cv;
       float y=(R + r*ct)*sv;
       float z= r*st;
       int id=j*Nu+i;
-      m.pos[3*id+0]=x; m.pos[3*id+1]=y; m.pos[3*id+2]=z;
-    }
-  }
-  int t=0;
-  for(int j=0;j<Nv-1;j++){
-    for(int i=0;i<Nu-1;i++){
-      int i0=j*Nu+i, i1=j*Nu+i+1, i2=(j+1)*Nu+i, i3=(j+1)*Nu+i+1;
-      m.idx[3*t+0]=i0; m.idx[3*t+1]=i2; m.idx[3*t+2]=i1; t++;
-      m.idx[3*t+0]=i1; m.idx[3*t+1]=i2; m.idx[3*t+2]=i3; t++;
-
-      float n[3];
-      const float* a=&m.pos[3*i0]; const float* b=&m.pos[3*i2]; const float* c=&m.pos[3*i1];
-      tri_normal(a,b,c,n); add_nor(m.nor,i0,n); add_nor(m.nor,i2,n); add_nor(m.nor,i1,n);
-      a=&m.pos[3*i1]; b=&m.pos[3*i2]; c=&m.pos[3*i3];
-      tri_normal(a,b,c,n); add_nor(m.nor,i1,n); add_nor(m.nor,i2,n); add_nor(m.nor,i3,n);
+      m->pos[3*id+0]=x; m->pos[3*id+1]=y; m->pos[3*id+2]=z;
     }
   }
-  normalize_all(m.nor, m.n_verts);
-  return m;
+  mesh_compute_normals(m);
 }
 
 /* ...existing code... */
 static float sgn(float x){ return (x>0)-(x<0); }
-static float pwr(float v,float e){ return powf(fabsf(v), e); }
 
 Mesh mesh_make_superellipsoid(int Nu,int Nv, float a,float b,float c, float e1,float e2){
-  Mesh m={0};
-  m.n_verts = Nu*Nv;
-  m.n_tris  = (Nu-1)*(Nv-1)*2;
-  m.pos = (float*)calloc(3*m.n_verts,sizeof(float));
-  m.nor = (float*)calloc(3*m.n_verts,sizeof(float));
-  m.idx = (unsigned int*)calloc(3*m.n_tris,sizeof(unsigned int));
-  if(!m.pos||!m.nor||!m.idx){ fprintf(stderr,"OOM superellipsoid\n"); exit(1); }
+  Mesh m = mesh_alloc(Nu*Nv, (Nu-1)*(Nv-1)*2);
+  grid_indices(&m, Nu,Nv);
+  mesh_update_superellipsoid(&m, Nu,Nv, a,b,c, e1,e2, NULL);
+  return m;
+}
+
+int mesh_superellipsoid_scratch_floats(int Nu,int Nv){ return 4*(Nu+Nv); }
 
+void mesh_update_superellipsoid(Mesh* m, int Nu,int Nv, float a,float b,float c, float e1,float e2,
+                                float* scratch){
+  /* The signed powers only depend on u or on v, so they are tabulated once per column / row
+     (2*(Nu+Nv) powers instead of 4*Nu*Nv) and batched through the vectorized kernel. */
+  float* tab=scratch;
+  if(!tab){
+    tab=(float*)malloc((size_t)mesh_superellipsoid_scratch_floats(Nu,Nv)*sizeof(float));
+    if(!tab){ fprintf(stderr,"OOM superellipsoid\n"); exit(1); }
+  }
+  float* cu_e1=tab;       float* su_e1=tab+Nu;
+  float* cv_e2=tab+2*Nu;  float* sv_e2=tab+2*Nu+Nv;
+  float* trig=tab+2*(Nu+Nv);
+  for(int i=0;i<Nu;i++){
+    float u = - (float)M_PI/2.0f + (float)i/(Nu-1)*(float)M_PI;
+    trig[i]=cosf(u); trig[Nu+i]=sinf(u);
+  }
+  pow_abs_array(cu_e1, trig, e1, Nu);
+  pow_abs_array(su_e1, trig+Nu, e1, Nu);
+  for(int i=0;i<Nu;i++){ cu_e1[i]*=sgn(trig[i]); su_e1[i]*=sgn(trig[Nu+i]); }
   for(int j=0;j<Nv;j++){
     float v = - (float)M_PI + (float)j/(Nv-1)*(2.0f*(float)M_PI);
-    float sv = sinf(v), cv = cosf(v);
-    for(int i=0;i<Nu;i++){
-      float u = - (float)M_PI/2.0f + (float)i/(Nu-1)*(float)M_PI;
-      float su = sinf(u), cu = cosf(u);
-
-      float cu_e1 = pwr(cu,e1), su_e1 = pwr(su,e1);
-      float cv_e2 = pwr(cv,e2), sv_e2 = pwr(sv,e2);
+    trig[j]=cosf(v); trig[Nv+j]=sinf(v);
+  }
+  pow_abs_array(cv_e2, trig, e2, Nv);
+  pow_abs_array(sv_e2, trig+Nv, e2, Nv);
+  for(int j=0;j<Nv;j++){ cv_e2[j]*=sgn(trig[j]); sv_e2[j]*=sgn(trig[Nv+j]); }
 
-      float x = a * sgn(cu)*cu_e1 * sgn(cv)*cv_e2;
-      float y = b * sgn(cu)*cu_e1 * sgn(sv)*sv_e2;
-      float z = c * sgn(su)*su_e1;
+  for(int j=0;j<Nv;j++){
+    for(int i=0;i<Nu;i++){
+      float x = a * cu_e1[i] * cv_e2[j];
+      float y = b * cu_e1[i] * sv_e2[j];
+      float z = c * su_e1[i];
 
       int id=j*Nu+i;
-      m.pos[3*id+0]=x; m.pos[3*id+1]=y; m.pos[3*id+2]=z;
-    }
-  }
-  int t=0;
-  for(int j=0;j<Nv-1;j++){
-    for(int i=0;i<Nu-1;i++){
-      int i0=j*Nu+i, i1=j*Nu+i+1, i2=(j+1)*Nu+i, i3=(j+1)*Nu+i+1;
-      m.idx[3*t+0]=i0; m.idx[3*t+1]=i2; m.idx[3*t+2]=i1; t++;
-      m.idx[3*t+0]=i1; m.idx[3*t+1]=i2; m.idx[3*t+2]=i3; t++;
-
-      float n[3];
-      const float* a=&m.pos[3*i0]; const float* b=&m.pos[3*i2]; const float* c=&m.pos[3*i1];
-      tri_normal(a,b,c,n); add_nor(m.nor,i0,n); add_nor(m.nor,i2,n); add_nor(m.nor,i1,n);
-      a=&m.pos[3*i1]; b=&m.pos[3*i2]; c=&m.pos[3*i3];
-      tri_normal(a,b,c,n); add_nor(m.nor,i1,n); add_nor(m.nor,i2,n); add_nor(m.nor,i3,n);
+      m->pos[3*id+0]=x; m->pos[3*id+1]=y; m->pos[3*id+2]=z;
     }
   }
-  normalize_all(m.nor, m.n_verts);
-  return m;
+  if(tab!=scratch) free(tab);
+  mesh_compute_normals(m);
 }
@@ -11,8 +11,20 @@ typedef struct {
 } Mesh;
 
 
+Mesh   mesh_alloc(int n_verts,int n_tris);
 void   mesh_free(Mesh* m);
 
+/* Smooth per-vertex normals averaged from the face normals (overwrites nor). */
+void   mesh_compute_normals(Mesh* m);
+/* Center of the AABB and the radius of the sphere around it enclosing every vertex. */
+void   mesh_bounds(const Mesh* m, float center[3], float* radius);
+/* Merges vertices closer than a small fraction of the bounding box (the u/v seams and poles of the
+   parametric builders). Returns the welded vertex count; remap[i] is the welded id of vertex i and
+   *out_pos (malloc'd) holds the welded positions. */
+int    mesh_weld_vertices(const Mesh* m, float** out_pos, int* remap);
+/* Welded copy of m without the triangles that collapse, with recomputed normals. */
+Mesh   mesh_weld(const Mesh* m);
+
 
 void   mesh_draw_triangles(const Mesh* m);
 
@@ -20,4 +32,13 @@ void   mesh_draw_triangles(const Mesh* m);
 Mesh   mesh_make_twisted_torus(int Nu,int Nv, float R,float r, int twist_k);
 Mesh   mesh_make_superellipsoid(int Nu,int Nv, float a,float b,float c, float e1,float e2);
 
+/* Rewrite pos/nor of a mesh made by the matching builder with the same Nu,Nv (indices are
+   unchanged), without reallocating; twist may be fractional for animation. The superellipsoid
+   tabulates its powers in scratch, which holds mesh_superellipsoid_scratch_floats(Nu,Nv) floats
+   owned by the caller (NULL allocates one for this call only). */
+void   mesh_update_twisted_torus(Mesh* m, int Nu,int Nv, float R,float r, float twist);
+int    mesh_superellipsoid_scratch_floats(int Nu,int Nv);
+void   mesh_update_superellipsoid(Mesh* m, int Nu,int Nv, float a,float b,float c, float e1,float e2,
+                                  float* scratch);
+
 #endif
@@ -0,0 +1,232 @@
+
+#ifdef _WIN32
+  #include <windows.h>
+  #include <GL/gl.h>
+#elif __APPLE__
+  #include <OpenGL/gl.h>
+#else
+  #include <GL/gl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "meshlet.h"
+
+/* Greedy clustering: each meshlet grows from a seed triangle through shared vertices, always taking
+   the candidate that adds the fewest new vertices, until the vertex or triangle budget is full. */
+
+static void meshlet_bounds(const Mesh* m, MeshletSet* s, Meshlet* c){
+  const unsigned int* V=&s->verts[c->vert_offset];
+  const unsigned char* T=&s->tris[3*c->tri_offset];
+
+  float lo[3], hi[3];
+  for(int k=0;k<3;k++){ lo[k]=hi[k]=m->pos[3*V[0]+k]; }
+  for(int i=1;i<c->n_verts;i++){
+    for(int k=0;k<3;k++){
+      float v=m->pos[3*V[i]+k];
+      if(v<lo[k]) lo[k]=v;
+      if(v>hi[k]) hi[k]=v;
+    }
+  }
+  for(int k=0;k<3;k++) c->center[k]=0.5f*(lo[k]+hi[k]);
+  float r2=0.0f;
+  for(int i=0;i<c->n_verts;i++){
+    const float* p=&m->pos[3*V[i]];
+    float dx=p[0]-c->center[0], dy=p[1]-c->center[1], dz=p[2]-c->center[2];
+    float d2=dx*dx+dy*dy+dz*dz;
+    if(d2>r2) r2=d2;
+  }
+  c->radius=sqrtf(r2);
+
+  /* Normal cone: mean face normal as axis, widest deviation as half-angle. */
+  float axis[3]={0,0,0};
+  float* fn=(float*)malloc(3*(size_t)c->n_tris*sizeof(float));
+  if(!fn){ fprintf(stderr,"OOM meshlet\n"); exit(1); }
+  for(int t=0;t<c->n_tris;t++){
+    const float* a=&m->pos[3*V[T[3*t+0]]];
+    const float* b=&m->pos[3*V[T[3*t+1]]];
+    const float* d=&m->pos[3*V[T[3*t+2]]];
+    float u[3]={ b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+    float v[3]={ d[0]-a[0], d[1]-a[1], d[2]-a[2] };
+    float n[3]={ u[1]*v[2]-u[2]*v[1], u[2]*v[0]-u[0]*v[2], u[0]*v[1]-u[1]*v[0] };
+    float L=sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+    if(L>1e-20f){ n[0]/=L; n[1]/=L; n[2]/=L; } else { n[0]=n[1]=n[2]=0.0f; }
+    fn[3*t+0]=n[0]; fn[3*t+1]=n[1]; fn[3*t+2]=n[2];
+    axis[0]+=n[0]; axis[1]+=n[1]; axis[2]+=n[2];
+  }
+  float L=sqrtf(axis[0]*axis[0]+axis[1]*axis[1]+axis[2]*axis[2]);
+  c->cone_cutoff=1.0f;
+  c->cone_axis[0]=0.0f; c->cone_axis[1]=0.0f; c->cone_axis[2]=1.0f;
+  if(L>1e-6f){
+    for(int k=0;k<3;k++) c->cone_axis[k]=axis[k]/L;
+    float mindp=1.0f;
+    for(int t=0;t<c->n_tris;t++){
+      const float* n=&fn[3*t];
+      if(n[0]==0.0f && n[1]==0.0f && n[2]==0.0f) continue;
+      float dp=n[0]*c->cone_axis[0]+n[1]*c->cone_axis[1]+n[2]*c->cone_axis[2];
+      if(dp<mindp) mindp=dp;
+    }
+    if(mindp>0.0f) c->cone_cutoff=sqrtf(1.0f-mindp*mindp);
+  }
+  free(fn);
+}
+
+MeshletSet meshlet_build(const Mesh* m){
+  MeshletSet s;
+  memset(&s,0,sizeof(s));
+  int nv=m->n_verts, nt=m->n_tris;
+
+  /* vertex -> triangle adjacency (CSR) */
+  int* off=(int*)calloc((size_t)nv+1,sizeof(int));
+  int* vt=(int*)malloc(3*(size_t)(nt>0?nt:1)*sizeof(int));
+  unsigned char* used=(unsigned char*)calloc((size_t)nt+1,1);
+  int* slot=(int*)malloc((size_t)(nv>0?nv:1)*sizeof(int));
+  int* cand=(int*)malloc(((size_t)MESHLET_MAX_VERTS*64+64)*sizeof(int));
+  s.meshlets=(Meshlet*)malloc((size_t)(nt>0?nt:1)*sizeof(Meshlet));
+  s.verts=(unsigned int*)malloc(3*(size_t)(nt>0?nt:1)*sizeof(unsigned int));
+  s.tris=(unsigned char*)malloc(3*(size_t)(nt>0?nt:1));
+  if(!off||!vt||!used||!slot||!cand||!s.meshlets||!s.verts||!s.tris){ fprintf(stderr,"OOM meshlet\n"); exit(1); }
+
+  for(int i=0;i<3*nt;i++) off[m->idx[i]+1]++;
+  for(int v=0;v<nv;v++) off[v+1]+=off[v];
+  {
+    int* fill=(int*)malloc((size_t)(nv>0?nv:1)*sizeof(int));
+    if(!fill){ fprintf(stderr,"OOM meshlet\n"); exit(1); }
+    memcpy(fill,off,(size_t)nv*sizeof(int));
+    for(int t=0;t<nt;t++) for(int k=0;k<3;k++) vt[fill[m->idx[3*t+k]]++]=t;
+    free(fill);
+  }
+  for(int v=0;v<nv;v++) slot[v]=-1;
+
+  const int cand_cap=MESHLET_MAX_VERTS*64+64;
+  unsigned int n_vrefs=0, n_trefs=0;
+  int seed=0;
+  for(;;){
+    while(seed<nt && used[seed]) seed++;
+    if(seed>=nt) break;
+
+    Meshlet* c=&s.meshlets[s.n_meshlets];
+    memset(c,0,sizeof(*c));
+    c->vert_offset=n_vrefs;
+    c->tri_offset=n_trefs;
+    int n_cand=0;
+    int next=seed;
+
+    while(next>=0){
+      int t=next;
+      used[t]=1;
+      for(int k=0;k<3;k++){
+        unsigned int v=m->idx[3*t+k];
+        if(slot[v]<0){
+          slot[v]=c->n_verts++;
+          s.verts[n_vrefs++]=v;
+          for(int j=off[v];j<off[v+1] && n_cand<cand_cap;j++) if(!used[vt[j]]) cand[n_cand++]=vt[j];
+        }
+        s.tris[3*n_trefs+k]=(unsigned char)slot[v];
+      }
+      n_trefs++;
+      c->n_tris++;
+      if(c->n_tris>=MESHLET_MAX_TRIS) break;
+
+      /* pick the adjacent triangle that adds the fewest new vertices */
+      next=-1;
+      int best=4, w=0;
+      for(int i=0;i<n_cand;i++){
+        int u=cand[i];
+        if(used[u]) continue;
+        cand[w++]=u;
+        int fresh=(slot[m->idx[3*u]]<0)+(slot[m->idx[3*u+1]]<0)+(slot[m->idx[3*u+2]]<0);
+        if(c->n_verts+fresh>MESHLET_MAX_VERTS) continue;
+        if(fresh<best){ best=fresh; next=u; }
+      }
+      n_cand=w;
+    }
+
+    for(int i=0;i<c->n_verts;i++) slot[s.verts[c->vert_offset+i]]=-1;
+    meshlet_bounds(m,&s,c);
+    s.n_meshlets++;
+  }
+
+  free(off); free(vt); free(used); free(slot); free(cand);
+  return s;
+}
+
+void meshlet_free(MeshletSet* s){
+  if(!s) return;
+  free(s->meshlets); free(s->verts); free(s->tris);
+  memset(s,0,sizeof(*s));
+}
+
+
+void meshlet_view_from_gl(MeshletView* v, const float mv[16], const float pr[16]){
+  /* clip = P * MV, column-major */
+  float c[16];
+  for(int col=0;col<4;col++)
+    for(int row=0;row<4;row++)
+      c[col*4+row]=pr[0*4+row]*mv[col*4+0] + pr[1*4+row]*mv[col*4+1]
+                  +pr[2*4+row]*mv[col*4+2] + pr[3*4+row]*mv[col*4+3];
+
+  /* Gribb-Hartmann: planes are row3 +/- row0..2, expressed in object space. */
+  for(int p=0;p<6;p++){
+    int row=p/2; float sgn=(p&1)? -1.0f : 1.0f;
+    for(int k=0;k<4;k++) v->planes[p][k]=c[k*4+3] + sgn*c[k*4+row];
+    float L=sqrtf(v->planes[p][0]*v->planes[p][0]+v->planes[p][1]*v->planes[p][1]+v->planes[p][2]*v->planes[p][2]);
+    if(L>0.0f) for(int k=0;k<4;k++) v->planes[p][k]/=L;
+  }
+
+  /* Inverse of the affine modelview: eye = -A^-1 t, view direction = A^-1 (0,0,-1). */
+  float a00=mv[0], a01=mv[4], a02=mv[8];
+  float a10=mv[1], a11=mv[5], a12=mv[9];
+  float a20=mv[2], a21=mv[6], a22=mv[10];
+  float i00=a11*a22-a12*a21, i01=a02*a21-a01*a22, i02=a01*a12-a02*a11;
+  float i10=a12*a20-a10*a22, i11=a00*a22-a02*a20, i12=a02*a10-a00*a12;
+  float i20=a10*a21-a11*a20, i21=a01*a20-a00*a21, i22=a00*a11-a01*a10;
+  float det=a00*i00+a01*i10+a02*i20;
+  float inv=(fabsf(det)>1e-20f)? 1.0f/det : 0.0f;
+  float tx=mv[12], ty=mv[13], tz=mv[14];
+  v->eye[0]=-(i00*tx+i01*ty+i02*tz)*inv;
+  v->eye[1]=-(i10*tx+i11*ty+i12*tz)*inv;
+  v->eye[2]=-(i20*tx+i21*ty+i22*tz)*inv;
+  float dx=-i02*inv, dy=-i12*inv, dz=-i22*inv;
+  float L=sqrtf(dx*dx+dy*dy+dz*dz);
+  if(L>0.0f){ dx/=L; dy/=L; dz/=L; }
+  v->view_dir[0]=dx; v->view_dir[1]=dy; v->view_dir[2]=dz;
+  v->ortho = (pr[11]==0.0f);
+}
+
+int meshlet_visible(const Meshlet* c, const MeshletView* v){
+  for(int p=0;p<6;p++){
+    const float* P=v->planes[p];
+    if(P[0]*c->center[0]+P[1]*c->center[1]+P[2]*c->center[2]+P[3] < -c->radius) return 0;
+  }
+  const float* a=c->cone_axis;
+  if(v->ortho){
+    if(a[0]*v->view_dir[0]+a[1]*v->view_dir[1]+a[2]*v->view_dir[2] > c->cone_cutoff) return 0;
+  }else{
+    float d[3]={ c->center[0]-v->eye[0], c->center[1]-v->eye[1], c->center[2]-v->eye[2] };
+    float L=sqrtf(d[0]*d[0]+d[1]*d[1]+d[2]*d[2]);
+    if(d[0]*a[0]+d[1]*a[1]+d[2]*a[2] >= c->cone_cutoff*L + c->radius) return 0;
+  }
+  return 1;
+}
+
+int meshlet_draw_visible(const MeshletSet* s, const Mesh* m, const MeshletView* v){
+  int drawn=0;
+  glBegin(GL_TRIANGLES);
+  for(int i=0;i<s->n_meshlets;i++){
+    const Meshlet* c=&s->meshlets[i];
+    if(!meshlet_visible(c,v)) continue;
+    const unsigned int* V=&s->verts[c->vert_offset];
+    const unsigned char* T=&s->tris[3*c->tri_offset];
+    for(int t=0;t<3*c->n_tris;t++){
+      unsigned int id=V[T[t]];
+      glNormal3fv(&m->nor[3*id]); glVertex3fv(&m->pos[3*id]);
+    }
+    drawn+=c->n_tris;
+  }
+  glEnd();
+  return drawn;
+}
@@ -0,0 +1,43 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include "mesh.h"
+
+#define MESHLET_MAX_VERTS 64
+#define MESHLET_MAX_TRIS  124
+
+/* Small cluster of a Mesh with its own bounding sphere and normal cone (object space). */
+typedef struct {
+  unsigned int vert_offset;     /* first entry in MeshletSet.verts */
+  unsigned int tri_offset;      /* first triangle in MeshletSet.tris (3 local bytes each) */
+  int   n_verts, n_tris;
+  float center[3], radius;
+  float cone_axis[3];
+  float cone_cutoff;            /* sin of the cone half-angle; 1 = never back-facing */
+} Meshlet;
+
+typedef struct {
+  int n_meshlets;
+  Meshlet* meshlets;
+  unsigned int* verts;          /* global vertex ids, per meshlet */
+  unsigned char* tris;          /* local vertex ids, 3 per triangle */
+} MeshletSet;
+
+/* Camera in the object space of one instance, derived from the current GL matrices. */
+typedef struct {
+  float planes[6][4];
+  float eye[3];                 /* perspective: camera position */
+  float view_dir[3];            /* orthographic: viewing direction */
+  int   ortho;
+} MeshletView;
+
+
+MeshletSet meshlet_build(const Mesh* m);
+void       meshlet_free(MeshletSet* s);
+
+void meshlet_view_from_gl(MeshletView* v, const float modelview[16], const float projection[16]);
+int  meshlet_visible(const Meshlet* c, const MeshletView* v);
+/* Submits every cluster that survives frustum and back-face cone culling; returns the triangle count. */
+int  meshlet_draw_visible(const MeshletSet* s, const Mesh* m, const MeshletView* v);
+
+#endif
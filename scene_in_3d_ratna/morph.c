@@ -0,0 +1,95 @@
+#ifdef _WIN32
+  #include <windows.h>
+  #include <GL/gl.h>
+  #include <GL/glext.h>
+#elif __APPLE__
+  #include <OpenGL/gl.h>
+#else
+  #define GL_GLEXT_PROTOTYPES
+  #include <GL/gl.h>
+  #include <GL/glext.h>
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "morph.h"
+
+#ifdef _WIN32
+/* opengl32.dll only exports GL 1.1; the buffer-object calls come from the driver
+   and can only be fetched once a context is current. */
+static PFNGLGENBUFFERSPROC    pglGenBuffers;
+static PFNGLBINDBUFFERPROC    pglBindBuffer;
+static PFNGLBUFFERDATAPROC    pglBufferData;
+static PFNGLBUFFERSUBDATAPROC pglBufferSubData;
+static PFNGLDELETEBUFFERSPROC pglDeleteBuffers;
+#define glGenBuffers    pglGenBuffers
+#define glBindBuffer    pglBindBuffer
+#define glBufferData    pglBufferData
+#define glBufferSubData pglBufferSubData
+#define glDeleteBuffers pglDeleteBuffers
+
+static void load_buffer_procs(void){
+  if(pglGenBuffers) return;
+  pglGenBuffers=(PFNGLGENBUFFERSPROC)wglGetProcAddress("glGenBuffers");
+  pglBindBuffer=(PFNGLBINDBUFFERPROC)wglGetProcAddress("glBindBuffer");
+  pglBufferData=(PFNGLBUFFERDATAPROC)wglGetProcAddress("glBufferData");
+  pglBufferSubData=(PFNGLBUFFERSUBDATAPROC)wglGetProcAddress("glBufferSubData");
+  pglDeleteBuffers=(PFNGLDELETEBUFFERSPROC)wglGetProcAddress("glDeleteBuffers");
+  if(!pglGenBuffers||!pglBindBuffer||!pglBufferData||!pglBufferSubData||!pglDeleteBuffers){
+    fprintf(stderr,"morph: GL 1.5 buffer objects unavailable\n"); exit(1);
+  }
+}
+#else
+static void load_buffer_procs(void){}
+#endif
+
+
+void morph_mesh_init(MorphMesh* mm, Mesh m){
+  load_buffer_procs();
+  memset(mm,0,sizeof(*mm));
+  mm->mesh = m;
+  mm->vbo_bytes = 2L*3L*m.n_verts*(long)sizeof(float);
+
+  glGenBuffers(1,&mm->ibo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mm->ibo);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, 3L*m.n_tris*(long)sizeof(unsigned int), m.idx, GL_STATIC_DRAW);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  glGenBuffers(1,&mm->vbo);
+  morph_mesh_upload(mm);
+}
+
+void morph_mesh_free(MorphMesh* mm){
+  if(!mm) return;
+  if(mm->vbo) glDeleteBuffers(1,&mm->vbo);
+  if(mm->ibo) glDeleteBuffers(1,&mm->ibo);
+  mesh_free(&mm->mesh);
+  free(mm->scratch);
+  memset(mm,0,sizeof(*mm));
+}
+
+void morph_mesh_upload(MorphMesh* mm){
+  long half = mm->vbo_bytes/2;
+  glBindBuffer(GL_ARRAY_BUFFER, mm->vbo);
+  glBufferData(GL_ARRAY_BUFFER, mm->vbo_bytes, NULL, GL_STREAM_DRAW);   /* orphan */
+  glBufferSubData(GL_ARRAY_BUFFER, 0,    half, mm->mesh.pos);
+  glBufferSubData(GL_ARRAY_BUFFER, half, half, mm->mesh.nor);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void morph_mesh_draw(const MorphMesh* mm){
+  glBindBuffer(GL_ARRAY_BUFFER, mm->vbo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mm->ibo);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_NORMAL_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, (const void*)0);
+  glNormalPointer(GL_FLOAT, 0, (const void*)(size_t)(mm->vbo_bytes/2));
+  glDrawElements(GL_TRIANGLES, 3*mm->mesh.n_tris, GL_UNSIGNED_INT, (const void*)0);
+  glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,25 @@
+#ifndef MORPH_H
+#define MORPH_H
+
+#include "mesh.h"
+
+/* A mesh whose vertices change every frame but whose topology does not. Indices live in a
+   static GL buffer uploaded once; positions and normals go through one streaming buffer that
+   is orphaned on every upload, so the driver hands out fresh storage instead of stalling on
+   the copy the GPU may still be reading. */
+typedef struct {
+  Mesh mesh;                 /* CPU copy, rewritten in place by the mesh_update_* functions */
+  float* scratch;            /* optional per-update tables (malloc'd by the owner, freed here) */
+  unsigned int vbo, ibo;
+  long vbo_bytes;
+} MorphMesh;
+
+/* Takes ownership of m. Needs a current GL context. */
+void morph_mesh_init(MorphMesh* mm, Mesh m);
+void morph_mesh_free(MorphMesh* mm);
+
+/* Orphans the vertex buffer and streams mesh.pos / mesh.nor into it. */
+void morph_mesh_upload(MorphMesh* mm);
+void morph_mesh_draw(const MorphMesh* mm);
+
+#endif
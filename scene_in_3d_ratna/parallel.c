@@ -0,0 +1,49 @@
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+typedef struct {
+  ParallelFn fn;
+  void* ctx;
+  int chunk, begin, end;
+} ParallelTask;
+
+static void* parallel_task_main(void* arg){
+  ParallelTask* t=(ParallelTask*)arg;
+  t->fn(t->ctx,t->chunk,t->begin,t->end);
+  return NULL;
+}
+
+int parallel_default_threads(void){
+  long n=sysconf(_SC_NPROCESSORS_ONLN);
+  return (n>0)? (int)n : 1;
+}
+
+int parallel_chunks(int n, int n_chunks){
+  if(n_chunks<=0) n_chunks=parallel_default_threads();
+  if(n_chunks>PARALLEL_MAX_CHUNKS) n_chunks=PARALLEL_MAX_CHUNKS;
+  if(n_chunks>n) n_chunks=n;
+  return (n_chunks>0)? n_chunks : 1;
+}
+
+void parallel_for(int n, int n_chunks, ParallelFn fn, void* ctx){
+  pthread_t th[PARALLEL_MAX_CHUNKS];
+  ParallelTask task[PARALLEL_MAX_CHUNKS];
+  int started[PARALLEL_MAX_CHUNKS];
+  n_chunks=parallel_chunks(n,n_chunks);
+  for(int c=0;c<n_chunks;c++){
+    task[c].fn=fn; task[c].ctx=ctx; task[c].chunk=c;
+    task[c].begin=parallel_chunk_begin(n,c,n_chunks);
+    task[c].end=parallel_chunk_begin(n,c+1,n_chunks);
+  }
+  for(int c=1;c<n_chunks;c++){
+    started[c]=(pthread_create(&th[c],NULL,parallel_task_main,&task[c])==0);
+    if(!started[c]) parallel_task_main(&task[c]);      /* out of threads: run inline */
+  }
+  parallel_task_main(&task[0]);
+  for(int c=1;c<n_chunks;c++) if(started[c]) pthread_join(th[c],NULL);
+}
@@ -0,0 +1,22 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#define PARALLEL_MAX_CHUNKS 64
+
+/* Called once per chunk with its index and its [begin,end) sub-range. */
+typedef void (*ParallelFn)(void* ctx, int chunk, int begin, int end);
+
+int  parallel_default_threads(void);
+
+/* Clamped chunk count for n items: n_chunks<=0 picks one per core. */
+int  parallel_chunks(int n, int n_chunks);
+
+static inline int parallel_chunk_begin(int n, int chunk, int n_chunks){
+  return (int)((long long)n*chunk/n_chunks);
+}
+
+/* Splits [0,n) into n_chunks contiguous ranges (see parallel_chunks) and runs fn on each in its own
+   pthread, the first on the calling thread. Returns when all chunks are done. */
+void parallel_for(int n, int n_chunks, ParallelFn fn, void* ctx);
+
+#endif
@@ -17,8 +17,17 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "mesh.h"
+#include "lod.h"
+#include "meshlet.h"
+#include "isosurface.h"
+#include "subdiv.h"
+#include "morph.h"
+#include "fastpow.h"
+#include "bench.h"
+#include "export.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -37,9 +46,44 @@ static float gYaw = 30.f, gPitch = 20.f;
 static float gDist = 18.f;
 static int   gPerspective = 0;
 static float gOrthoHalf = 10.f;
-
-static Mesh gTorus;
-static Mesh gSuper;
+static const float gFovY = 55.0f;
+
+/* Projected diameter (pixels) at which an instance needs its full-detail level. */
+#define LOD_REF_PX 600.0f
+static const float gLodRatios[] = { 1.0f, 0.5f, 0.25f, 0.1f };
+static int   gUseLod = 1;
+static int   gUseClusters = 1;
+static int   gUseImplicit = 1;
+
+/* Morph mode: twist and exponents animate every frame, regenerated in place at MORPH_N x MORPH_N. */
+#define MORPH_N 256
+static int   gMorph = 0;
+static MorphMesh gMorphTorus, gMorphSuper;
+static int   gTrisDrawn = 0, gTrisTotal = 0;
+
+/* LOD chain plus the meshlet clusters of every level. */
+typedef struct {
+  MeshLod    lod;
+  MeshletSet clusters[MESH_LOD_MAX];
+} SceneMesh;
+
+static SceneMesh gTorus;
+static SceneMesh gSuper;      /* parametric (u,v) tessellation */
+static SceneMesh gSuperIso;   /* same superquadric, contoured from its implicit field */
+static SceneMesh gBlob;       /* superquadric smoothly blended into a torus */
+
+/* Placement shared by drawing and export: translate, rotate z/y/x (degrees), scale, colour. */
+typedef struct { float t[3], r[3], s[3], c[3]; } Placement;
+
+static const Placement gTorusAt = { {0.0f,0.0f,0.0f}, {0,0,0}, {1,1,1}, {0.95f,0.5f,0.2f} };
+static const Placement gSuperAt[] = {
+  { {-6.0f,-2.0f,-3.0f}, {0, 20,0}, {2.0f,1.2f,2.0f}, {0.3f,0.7f,0.9f} },
+  { {-2.0f,-2.0f, 5.0f}, {0,-30,0}, {1.2f,2.4f,1.2f}, {0.9f,0.7f,0.3f} },
+  { { 6.0f,-2.0f,-5.0f}, {0, 60,0}, {1.6f,1.6f,2.6f}, {0.5f,0.9f,0.5f} },
+  { { 3.0f,-2.0f, 2.0f}, {0,-10,0}, {2.4f,1.1f,1.1f}, {0.8f,0.5f,0.9f} },
+};
+static const Placement gBlobAt = { {-7.5f,-0.9f,6.5f}, {-90,35,0}, {1.1f,1.1f,1.1f}, {0.9f,0.4f,0.5f} };
+#define N_SUPER ((int)(sizeof(gSuperAt)/sizeof(gSuperAt[0])))
 
 
 static void draw_axes(float L){
@@ -56,7 +100,7 @@ static void set_projection(void){
   glLoadIdentity();
   float asp = (gH>0) ? (float)gW/(float)gH : 1.0f;
   if(gPerspective){
-    gluPerspective(55.0, asp, 0.1, 1000.0);
+    gluPerspective(gFovY, asp, 0.1, 1000.0);
   }else{
     float s = gOrthoHalf;
     if (asp >= 1.0f)
@@ -67,23 +111,100 @@ static void set_projection(void){
   glMatrixMode(GL_MODELVIEW);
 }
 
-static void draw_mesh_instanced(const Mesh* m,
-                                float tx,float ty,float tz,
-                                float rx,float ry,float rz,
-                                float sx,float sy,float sz,
-                                float cr,float cg,float cb)
+static void eye_position(float e[3]){
+  float cy = (float)(gDist*cos(gPitch*M_PI/180.0)*cos(gYaw*M_PI/180.0));
+  float cx = (float)(gDist*cos(gPitch*M_PI/180.0)*sin(gYaw*M_PI/180.0));
+  float cz = (float)(gDist*sin(gPitch*M_PI/180.0));
+  e[0]=cx; e[1]=cz; e[2]=cy;
+}
+
+/* Diameter in pixels of a world-space sphere under the current projection. */
+static float projected_px(float x,float y,float z, float r){
+  if(gPerspective){
+    float e[3]; eye_position(e);
+    float dx=x-e[0], dy=y-e[1], dz=z-e[2];
+    float d=sqrtf(dx*dx+dy*dy+dz*dz);
+    if(d<=r) return 1e9f;
+    return r*(float)gH/(d*tanf(0.5f*gFovY*(float)M_PI/180.0f));
+  }
+  float asp = (gH>0) ? (float)gW/(float)gH : 1.0f;
+  float halfH = (asp>=1.0f) ? gOrthoHalf : gOrthoHalf/asp;
+  return r*(float)gH/halfH;
+}
+
+static void scene_mesh_build(SceneMesh* sm, const Mesh* src){
+  int n = (int)(sizeof(gLodRatios)/sizeof(gLodRatios[0]));
+  sm->lod = mesh_lod_build(src, gLodRatios, n);
+  for(int i=0;i<sm->lod.n_levels;i++) sm->clusters[i] = meshlet_build(&sm->lod.level[i]);
+}
+
+static void scene_mesh_free(SceneMesh* sm){
+  for(int i=0;i<sm->lod.n_levels;i++) meshlet_free(&sm->clusters[i]);
+  mesh_lod_free(&sm->lod);
+}
+
+static void instance_transform(float tx,float ty,float tz,
+                               float rx,float ry,float rz,
+                               float sx,float sy,float sz)
 {
+  glTranslatef(tx,ty,tz);
+  glRotatef(rz,0,0,1);
+  glRotatef(ry,0,1,0);
+  glRotatef(rx,1,0,0);
+  glScalef(sx,sy,sz);
+}
+
+static void draw_mesh_instanced(const SceneMesh* sm, const Placement* at){
+  float tx=at->t[0], ty=at->t[1], tz=at->t[2];
+  float sx=at->s[0], sy=at->s[1], sz=at->s[2];
+  /* Meshes are built around the origin, so the translation is a good enough sphere center. */
+  const MeshLod* lod = &sm->lod;
+  float s = sx; if(sy>s) s=sy; if(sz>s) s=sz;
+  const Mesh* m = gUseLod ? mesh_lod_select(lod, projected_px(tx,ty,tz, lod->radius*s), LOD_REF_PX)
+                          : &lod->level[0];
+  const MeshletSet* clusters = &sm->clusters[m - lod->level];
+  glPushMatrix();
+    instance_transform(tx,ty,tz, at->r[0],at->r[1],at->r[2], sx,sy,sz);
+    glColor3f(at->c[0],at->c[1],at->c[2]);
+    gTrisTotal += m->n_tris;
+    if(gUseClusters){
+      float mv[16], pr[16];
+      MeshletView view;
+      glGetFloatv(GL_MODELVIEW_MATRIX, mv);
+      glGetFloatv(GL_PROJECTION_MATRIX, pr);
+      meshlet_view_from_gl(&view, mv, pr);
+      gTrisDrawn += meshlet_draw_visible(clusters, m, &view);
+    }else{
+      mesh_draw_triangles(m);
+      gTrisDrawn += m->n_tris;
+    }
+  glPopMatrix();
+}
+
+static void draw_morph_instanced(const MorphMesh* mm, const Placement* at){
   glPushMatrix();
-    glTranslatef(tx,ty,tz);
-    glRotatef(rz,0,0,1);
-    glRotatef(ry,0,1,0);
-    glRotatef(rx,1,0,0);
-    glScalef(sx,sy,sz);
-    glColor3f(cr,cg,cb);
-    mesh_draw_triangles(m);
+    instance_transform(at->t[0],at->t[1],at->t[2], at->r[0],at->r[1],at->r[2], at->s[0],at->s[1],at->s[2]);
+    glColor3f(at->c[0],at->c[1],at->c[2]);
+    morph_mesh_draw(mm);
   glPopMatrix();
+  gTrisTotal += mm->mesh.n_tris;
+  gTrisDrawn += mm->mesh.n_tris;
 }
 
+/* Regenerates both morph meshes into their existing storage and streams them to the GPU. */
+static void morph_step(void){
+  float t = 0.001f*(float)glutGet(GLUT_ELAPSED_TIME);
+  float twist = 2.0f + 1.5f*sinf(0.5f*t);
+  float e1 = 0.25f + 0.9f*(0.5f+0.5f*sinf(0.8f*t));
+  float e2 = 0.25f + 0.9f*(0.5f+0.5f*cosf(0.6f*t));
+  mesh_update_twisted_torus(&gMorphTorus.mesh, MORPH_N,MORPH_N, 5.0f,1.2f, twist);
+  mesh_update_superellipsoid(&gMorphSuper.mesh, MORPH_N,MORPH_N, 1.0f,1.0f,1.0f, e1,e2, gMorphSuper.scratch);
+  morph_mesh_upload(&gMorphTorus);
+  morph_mesh_upload(&gMorphSuper);
+}
+
+static void idle(void){ glutPostRedisplay(); }
+
 
 static void display(void){
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -92,13 +213,12 @@ static void display(void){
   glCullFace(GL_BACK);
 
   set_projection();
+  gTrisDrawn = gTrisTotal = 0;
 
   glLoadIdentity();
   if(gPerspective){
-    float cy = (float)(gDist*cos(gPitch*M_PI/180.0)*cos(gYaw*M_PI/180.0));
-    float cx = (float)(gDist*cos(gPitch*M_PI/180.0)*sin(gYaw*M_PI/180.0));
-    float cz = (float)(gDist*sin(gPitch*M_PI/180.0));
-    gluLookAt(cx,cz,cy,  0,0,0,  0,1,0);
+    float e[3]; eye_position(e);
+    gluLookAt(e[0],e[1],e[2],  0,0,0,  0,1,0);
   }else{
     glRotatef(gPitch,1,0,0);
     glRotatef(gYaw,0,1,0);
@@ -115,16 +235,19 @@ static void display(void){
     glVertex3f(-12, -2.2f,  12);
   glEnd();
 
-  draw_mesh_instanced(&gTorus, 0.0f, 0.0f, 0.0f,   0, 0, 0,   1,1,1,   0.95f,0.5f,0.2f);
-
-
-  draw_mesh_instanced(&gSuper, -6.0f,-2.0f,-3.0f,  0, 20, 0,   2.0f,1.2f,2.0f,   0.3f,0.7f,0.9f);
-  draw_mesh_instanced(&gSuper, -2.0f,-2.0f, 5.0f,  0,-30, 0,   1.2f,2.4f,1.2f,   0.9f,0.7f,0.3f);
-  draw_mesh_instanced(&gSuper,  6.0f,-2.0f,-5.0f,  0, 60, 0,   1.6f,1.6f,2.6f,   0.5f,0.9f,0.5f);
-  draw_mesh_instanced(&gSuper,  3.0f,-2.0f, 2.0f,  0,-10, 0,   2.4f,1.1f,1.1f,   0.8f,0.5f,0.9f);
+  if(gMorph){
+    morph_step();
+    draw_morph_instanced(&gMorphTorus, &gTorusAt);
+    for(int i=0;i<N_SUPER;i++) draw_morph_instanced(&gMorphSuper, &gSuperAt[i]);
+  }else{
+    draw_mesh_instanced(&gTorus, &gTorusAt);
+    const SceneMesh* super = gUseImplicit ? &gSuperIso : &gSuper;
+    for(int i=0;i<N_SUPER;i++) draw_mesh_instanced(super, &gSuperAt[i]);
+  }
 
-  glutSwapBuffers();
+  draw_mesh_instanced(&gBlob, &gBlobAt);
 
+  glDisable(GL_DEPTH_TEST);
   glMatrixMode(GL_PROJECTION);
   glPushMatrix();
   glLoadIdentity();
@@ -133,13 +256,21 @@ static void display(void){
   glPushMatrix();
   glLoadIdentity();
   glColor3f(1,1,1);
-  const char* hud = "Arrows: rotate | PgUp/PgDn: zoom | p: perspective | r: reset";
+  const char* hud = "Arrows: rotate | PgUp/PgDn: zoom | p: perspective | l: LOD | c: clusters | i: implicit | m: morph | r: reset";
   glRasterPos2i(20, 30);
   for(const char* c=hud; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+  char stats[128];
+  snprintf(stats, sizeof(stats), "triangles %d / %d  (LOD %s, cluster culling %s)",
+           gTrisDrawn, gTrisTotal, gUseLod?"on":"off", gUseClusters?"on":"off");
+  glRasterPos2i(20, 55);
+  for(const char* c=stats; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
   glPopMatrix();
   glMatrixMode(GL_PROJECTION);
   glPopMatrix();
   glMatrixMode(GL_MODELVIEW);
+  glEnable(GL_DEPTH_TEST);
+
+  glutSwapBuffers();
 }
 
 static void reshape(int w,int h){
@@ -169,26 +300,103 @@ static void special(int key,int x,int y){
   glutPostRedisplay();
 }
 
+static ExportInstance export_instance(const Mesh* m, const Placement* at){
+  ExportInstance e;
+  e.mesh = m;
+  for(int k=0;k<3;k++){ e.t[k]=at->t[k]; e.r_deg[k]=at->r[k]; e.s[k]=at->s[k]; e.color[k]=at->c[k]; }
+  return e;
+}
+
+/* Writes what is on screen (full-detail levels, or the current morph frame) as .glb or .ply. */
+static int scene_export(const char* path){
+  ExportInstance inst[2+N_SUPER];
+  int n=0;
+  const Mesh* torus = gMorph ? &gMorphTorus.mesh : &gTorus.lod.level[0];
+  const Mesh* super = gMorph ? &gMorphSuper.mesh : gUseImplicit ? &gSuperIso.lod.level[0] : &gSuper.lod.level[0];
+  inst[n++] = export_instance(torus, &gTorusAt);
+  for(int i=0;i<N_SUPER;i++) inst[n++] = export_instance(super, &gSuperAt[i]);
+  inst[n++] = export_instance(&gBlob.lod.level[0], &gBlobAt);
+
+  size_t len = strlen(path);
+  int ply = len>=4 && strcmp(path+len-4,".ply")==0;
+  int rc = ply ? export_ply(path, inst, n) : export_glb(path, inst, n);
+  if(rc==0) printf("exported %s\n", path);
+  return rc;
+}
+
 static void keyboard(unsigned char k,int x,int y){
   (void)x; (void)y;
   switch(k){
-    case 27: mesh_free(&gTorus); mesh_free(&gSuper); exit(0);
+    case 27:
+      scene_mesh_free(&gTorus); scene_mesh_free(&gSuper);
+      scene_mesh_free(&gSuperIso); scene_mesh_free(&gBlob);
+      morph_mesh_free(&gMorphTorus); morph_mesh_free(&gMorphSuper);
+      exit(0);
     case 'p': case 'P': gPerspective ^= 1; glutPostRedisplay(); break;
+    case 'l': case 'L': gUseLod ^= 1; glutPostRedisplay(); break;
+    case 'c': case 'C': gUseClusters ^= 1; glutPostRedisplay(); break;
+    case 'i': case 'I': gUseImplicit ^= 1; glutPostRedisplay(); break;
+    case 'm': case 'M': gMorph ^= 1; glutIdleFunc(gMorph ? idle : NULL); glutPostRedisplay(); break;
+    case 'e': case 'E': scene_export("scene.glb"); break;
+    case 'f': case 'F':
+      pow_set_impl(pow_get_impl()==POW_FAST ? POW_LIBM : POW_FAST);
+      printf("superquadric powers: %s\n", pow_impl_name(pow_get_impl()));
+      break;
     case 'r': case 'R': gYaw=30.f; gPitch=20.f; gDist=18.f; gOrthoHalf=10.f; glutPostRedisplay(); break;
   }
 }
 
 
 int main(int argc,char** argv){
+  if(argc>1 && strcmp(argv[1],"--bench")==0) return run_benchmarks();
   
-  gTorus = mesh_make_twisted_torus(80,80, 5.0f,1.2f, 2);
-  gSuper = mesh_make_superellipsoid(50,60, 1.0f,1.0f,1.0f, 0.4f,0.4f);
+  /* Only a coarse control torus is evaluated; Loop subdivision refines it to ~49k triangles. */
+  Mesh torus_cage = mesh_make_twisted_torus(40,40, 5.0f,1.2f, 2);
+  Mesh torus = mesh_subdivide_loop(&torus_cage, 2, 0);
+  mesh_free(&torus_cage);
+  Mesh super = mesh_make_superellipsoid(100,120, 1.0f,1.0f,1.0f, 0.4f,0.4f);
+  scene_mesh_build(&gTorus, &torus);
+  scene_mesh_build(&gSuper, &super);
+  mesh_free(&torus); mesh_free(&super);
+
+  /* The (u,v) superellipsoid bunches vertices at the poles and thins them on the flat faces;
+     contouring the implicit field gives an even density over the whole surface. */
+  static const Superquadric sq = { 1.0f,1.0f,1.0f, 0.4f,0.4f };
+  const float sq_lo[3] = { -1.1f,-1.1f,-1.1f }, sq_hi[3] = { 1.1f,1.1f,1.1f };
+  Mesh super_iso = mesh_make_implicit(implicit_superquadric, &sq, sq_lo, sq_hi, 80,80,80, 0);
+  scene_mesh_build(&gSuperIso, &super_iso);
+  mesh_free(&super_iso);
+
+  static const Superquadric blob_core = { 0.8f,0.8f,0.9f, 0.6f,0.6f };
+  static const ImplicitTorus blob_ring = { 1.0f, 0.25f };
+  static const ImplicitBlend blob = {
+    implicit_superquadric, &blob_core, { 0.0f,0.0f,0.0f },
+    implicit_torus,        &blob_ring, { 0.0f,0.0f,-0.3f },
+    0.35f
+  };
+  const float blob_lo[3] = { -1.5f,-1.5f,-1.2f }, blob_hi[3] = { 1.5f,1.5f,1.2f };
+  Mesh blob_mesh = mesh_make_implicit(implicit_blend, &blob, blob_lo, blob_hi, 96,96,80, 0);
+  scene_mesh_build(&gBlob, &blob_mesh);
+  mesh_free(&blob_mesh);
+
+  if(argc>2 && strcmp(argv[1],"--export")==0){
+    int rc = scene_export(argv[2]);
+    scene_mesh_free(&gTorus); scene_mesh_free(&gSuper);
+    scene_mesh_free(&gSuperIso); scene_mesh_free(&gBlob);
+    return rc==0 ? 0 : 1;
+  }
 
   glutInit(&argc, argv);
   glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH);
   glutInitWindowSize(gW,gH);
   glutCreateWindow("Procedural 3D Scene — Instancing & View Control");
 
+  /* buffers need the context; the meshes are allocated once and rewritten in place afterwards */
+  morph_mesh_init(&gMorphTorus, mesh_make_twisted_torus(MORPH_N,MORPH_N, 5.0f,1.2f, 2));
+  morph_mesh_init(&gMorphSuper, mesh_make_superellipsoid(MORPH_N,MORPH_N, 1.0f,1.0f,1.0f, 0.4f,0.4f));
+  gMorphSuper.scratch=(float*)malloc((size_t)mesh_superellipsoid_scratch_floats(MORPH_N,MORPH_N)*sizeof(float));
+  if(!gMorphSuper.scratch){ fprintf(stderr,"OOM morph\n"); exit(1); }
+
   glClearColor(0.05f,0.06f,0.08f,1.0f);
   glEnable(GL_DEPTH_TEST);
 
@@ -0,0 +1,204 @@
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "subdiv.h"
+#include "halfedge.h"
+#include "parallel.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Loop (1987) subdivision. Vertex rule (1-n*beta) v + beta * sum(ring) with
+   beta = (5/8 - (3/8 + cos(2pi/n)/4)^2) / n; edge rule 3/8 (a+b) + 1/8 (c+d).
+   Boundary vertices use 3/4 v + 1/8 (both boundary neighbours), boundary edges the midpoint,
+   so open borders and seams refine as cubic B-splines and stay crack-free. */
+
+typedef struct {
+  int n, cap;
+  int* src;
+  float* w;
+} StencilBuf;
+
+static void stencil_push(StencilBuf* S, int src, float w){
+  if(S->n==S->cap){
+    S->cap = S->cap ? 2*S->cap : 1024;
+    S->src=(int*)realloc(S->src,(size_t)S->cap*sizeof(int));
+    S->w=(float*)realloc(S->w,(size_t)S->cap*sizeof(float));
+    if(!S->src||!S->w){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+  }
+  S->src[S->n]=src; S->w[S->n]=w; S->n++;
+}
+
+static float loop_beta(int n){
+  float c=0.375f+0.25f*cosf(2.0f*(float)M_PI/(float)n);
+  return (0.625f-c*c)/(float)n;
+}
+
+/* Builds level L from the n_verts/n_tris/idx of the previous level. */
+static void build_level(SubdivLevel* L, int n_verts, int n_tris, const unsigned int* idx){
+  Mesh topo={0};
+  topo.n_verts=n_verts; topo.n_tris=n_tris; topo.idx=(unsigned int*)idx;
+  HalfEdgeMesh H=halfedge_build(&topo);
+
+  int* edge_of=(int*)malloc((size_t)(H.n_half>0?H.n_half:1)*sizeof(int));
+  if(!edge_of){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+  int n_out=n_verts;
+  for(int h=0;h<H.n_half;h++){
+    int g=H.twin[h];
+    if(g>=0 && g<h) edge_of[h]=edge_of[g];
+    else edge_of[h]=n_out++;
+  }
+
+  L->n_in=n_verts; L->n_out=n_out;
+  L->off=(int*)malloc(((size_t)n_out+1)*sizeof(int));
+  if(!L->off){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+  StencilBuf S={0};
+
+  int ring_cap=64;
+  unsigned int* ring=(unsigned int*)malloc((size_t)ring_cap*sizeof(unsigned int));
+  if(!ring){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+  for(int v=0;v<n_verts;v++){
+    L->off[v]=S.n;
+    int n=halfedge_vertex_ring(&H,&topo,v,ring,ring_cap);
+    if(n>ring_cap){
+      ring_cap=n;
+      ring=(unsigned int*)realloc(ring,(size_t)ring_cap*sizeof(unsigned int));
+      if(!ring){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+      n=halfedge_vertex_ring(&H,&topo,v,ring,ring_cap);
+    }
+    if(n<2){
+      stencil_push(&S,v,1.0f);                    /* unused vertex */
+    }else if(halfedge_is_boundary_vertex(&H,v)){
+      stencil_push(&S,v,0.75f);
+      stencil_push(&S,(int)ring[0],0.125f);
+      stencil_push(&S,(int)ring[n-1],0.125f);
+    }else{
+      float beta=loop_beta(n);
+      stencil_push(&S,v,1.0f-(float)n*beta);
+      for(int k=0;k<n;k++) stencil_push(&S,(int)ring[k],beta);
+    }
+  }
+  free(ring);
+
+  for(int h=0;h<H.n_half;h++){
+    int g=H.twin[h];
+    if(g>=0 && g<h) continue;
+    L->off[edge_of[h]]=S.n;
+    int a=(int)he_origin(&topo,h), b=(int)he_dest(&topo,h);
+    if(g<0){
+      stencil_push(&S,a,0.5f); stencil_push(&S,b,0.5f);
+    }else{
+      stencil_push(&S,a,0.375f); stencil_push(&S,b,0.375f);
+      stencil_push(&S,(int)he_origin(&topo,he_prev(h)),0.125f);
+      stencil_push(&S,(int)he_origin(&topo,he_prev(g)),0.125f);
+    }
+  }
+  L->off[n_out]=S.n;
+  L->src=S.src; L->w=S.w;
+
+  L->n_tris=4*n_tris;
+  L->idx=(unsigned int*)malloc(3*(size_t)(L->n_tris>0?L->n_tris:1)*sizeof(unsigned int));
+  if(!L->idx){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+  for(int t=0;t<n_tris;t++){
+    unsigned int a=idx[3*t], b=idx[3*t+1], c=idx[3*t+2];
+    unsigned int ab=(unsigned int)edge_of[3*t], bc=(unsigned int)edge_of[3*t+1], ca=(unsigned int)edge_of[3*t+2];
+    unsigned int* o=&L->idx[12*t];
+    o[0]=a;  o[1]=ab; o[2]=ca;
+    o[3]=ab; o[4]=b;  o[5]=bc;
+    o[6]=ca; o[7]=bc; o[8]=c;
+    o[9]=ab; o[10]=bc; o[11]=ca;
+  }
+  free(edge_of);
+  halfedge_free(&H);
+}
+
+SubdivPlan subdiv_plan_build(const Mesh* control, int levels){
+  SubdivPlan P;
+  memset(&P,0,sizeof(P));
+  if(levels<0) levels=0;
+  if(levels>SUBDIV_MAX_LEVELS) levels=SUBDIV_MAX_LEVELS;
+  int nv=control->n_verts, nt=control->n_tris;
+  const unsigned int* idx=control->idx;
+  for(int l=0;l<levels;l++){
+    build_level(&P.level[l],nv,nt,idx);
+    nv=P.level[l].n_out; nt=P.level[l].n_tris; idx=P.level[l].idx;
+    P.n_levels++;
+  }
+  return P;
+}
+
+void subdiv_plan_free(SubdivPlan* P){
+  if(!P) return;
+  for(int l=0;l<P->n_levels;l++){
+    free(P->level[l].off); free(P->level[l].src); free(P->level[l].w); free(P->level[l].idx);
+  }
+  memset(P,0,sizeof(*P));
+}
+
+Mesh subdiv_plan_alloc_mesh(const SubdivPlan* P){
+  /* a zero-level plan has no topology of its own; callers keep using the control mesh */
+  if(P->n_levels==0) return mesh_alloc(0,0);
+  const SubdivLevel* L=&P->level[P->n_levels-1];
+  Mesh m=mesh_alloc(L->n_out,L->n_tris);
+  memcpy(m.idx,L->idx,3*(size_t)L->n_tris*sizeof(unsigned int));
+  return m;
+}
+
+
+typedef struct {
+  const SubdivLevel* L;
+  const float* in;
+  float* out;
+} ApplyJob;
+
+static void apply_range(void* ctx, int chunk, int begin, int end){
+  const ApplyJob* J=(const ApplyJob*)ctx;
+  const SubdivLevel* L=J->L;
+  (void)chunk;
+  for(int i=begin;i<end;i++){
+    float x=0.0f, y=0.0f, z=0.0f;
+    for(int k=L->off[i];k<L->off[i+1];k++){
+      const float* p=&J->in[3*L->src[k]];
+      float w=L->w[k];
+      x+=w*p[0]; y+=w*p[1]; z+=w*p[2];
+    }
+    J->out[3*i]=x; J->out[3*i+1]=y; J->out[3*i+2]=z;
+  }
+}
+
+void subdiv_plan_apply(const SubdivPlan* P, const float* ctrl_pos, Mesh* out, int n_threads){
+  if(P->n_levels==0) return;
+  /* intermediate levels ping-pong between two scratch buffers; the last one lands in out */
+  float* scratch[2]={ NULL, NULL };
+  const float* in=ctrl_pos;
+  for(int l=0;l<P->n_levels;l++){
+    const SubdivLevel* L=&P->level[l];
+    float* dst;
+    if(l==P->n_levels-1) dst=out->pos;
+    else{
+      scratch[l&1]=(float*)realloc(scratch[l&1],3*(size_t)L->n_out*sizeof(float));
+      if(!scratch[l&1]){ fprintf(stderr,"OOM subdiv\n"); exit(1); }
+      dst=scratch[l&1];
+    }
+    ApplyJob J={ L, in, dst };
+    parallel_for(L->n_out,n_threads,apply_range,&J);
+    in=dst;
+  }
+  free(scratch[0]); free(scratch[1]);
+  mesh_compute_normals(out);
+}
+
+Mesh mesh_subdivide_loop(const Mesh* control, int levels, int n_threads){
+  Mesh w=mesh_weld(control);
+  if(levels<=0) return w;
+  SubdivPlan P=subdiv_plan_build(&w,levels);
+  Mesh m=subdiv_plan_alloc_mesh(&P);
+  subdiv_plan_apply(&P,w.pos,&m,n_threads);
+  subdiv_plan_free(&P);
+  mesh_free(&w);
+  return m;
+}
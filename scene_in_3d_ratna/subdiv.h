@@ -0,0 +1,39 @@
+#ifndef SUBDIV_H
+#define SUBDIV_H
+
+#include "mesh.h"
+
+#define SUBDIV_MAX_LEVELS 6
+
+/* One Loop refinement step as a linear map: refined vertex i is sum_k w[k] * coarse[src[k]]
+   for k in [off[i], off[i+1]). Old vertices keep their ids, edge vertices follow. */
+typedef struct {
+  int n_in, n_out;
+  int* off;
+  int* src;
+  float* w;
+  int n_tris;
+  unsigned int* idx;   /* refined triangles */
+} SubdivLevel;
+
+/* Topology-only plan: built once per control mesh, then re-applied whenever the control
+   positions move (only the stencils run, no adjacency work). */
+typedef struct {
+  int n_levels;
+  SubdivLevel level[SUBDIV_MAX_LEVELS];
+} SubdivPlan;
+
+/* control should be welded (mesh_weld); open edges get the boundary (crease) rules. */
+SubdivPlan subdiv_plan_build(const Mesh* control, int levels);
+void       subdiv_plan_free(SubdivPlan* plan);
+
+/* Mesh sized and indexed for the finest level; fill it with subdiv_plan_apply. */
+Mesh       subdiv_plan_alloc_mesh(const SubdivPlan* plan);
+/* Runs the stencils level by level on n_threads threads (<=0: one per core) from control
+   positions ctrl_pos and writes positions and normals into out. */
+void       subdiv_plan_apply(const SubdivPlan* plan, const float* ctrl_pos, Mesh* out, int n_threads);
+
+/* Welds control and refines it by levels Loop steps. */
+Mesh       mesh_subdivide_loop(const Mesh* control, int levels, int n_threads);
+
+#endif